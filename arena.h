@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump allocator for the int arrays of a depth-first search. Allocations are
+// released in LIFO order by rolling back to a mark taken before them; the
+// chunks stay owned by the arena, so once it has grown to the deepest path
+// of the search, further allocations never touch the heap. Not thread-safe:
+// every worker owns its own arena.
+class Arena {
+    struct Chunk {
+        std::unique_ptr<int[]> data;
+        size_t capacity;
+    };
+    std::vector<Chunk> chunks;
+    size_t current = 0;
+    size_t used = 0;
+
+    static constexpr size_t kChunkInts = size_t(1) << 20;
+
+public:
+    struct Mark {
+        size_t chunk;
+        size_t used;
+    };
+
+    Mark mark() const { return {current, used}; }
+
+    void release(Mark m) {
+        current = m.chunk;
+        used = m.used;
+    }
+
+    int* alloc(size_t n) {
+        if (chunks.empty()) {
+            chunks.push_back({std::unique_ptr<int[]>(new int[std::max(n, kChunkInts)]), std::max(n, kChunkInts)});
+        }
+        if (used + n > chunks[current].capacity) {
+            // Chunks past the current one are free, so a too-small one can be replaced.
+            ++current;
+            used = 0;
+            if (current == chunks.size()) {
+                chunks.push_back({nullptr, 0});
+            }
+            if (chunks[current].capacity < n) {
+                const size_t capacity = std::max(n, kChunkInts);
+                chunks[current] = {std::unique_ptr<int[]>(new int[capacity]), capacity};
+            }
+        }
+        int* p = chunks[current].data.get() + used;
+        used += n;
+        return p;
+    }
+};
@@ -0,0 +1,396 @@
+// Benchmark for the clique engines on synthetic graphs.
+//
+// Every engine runs on every generated graph from its own in-memory copy,
+// so only ordering and enumeration are timed. Results go out as JSON (time,
+// search-tree nodes, maximal cliques and cliques per second per run) to be
+// diffed between versions:
+//
+//   g++ -std=c++17 -O2 -pthread bench.cpp -o bench
+//   ./bench --graphs er:5000:16,mm:10 --reps 5 --out bench.json
+#include <bits/stdc++.h>
+
+#include "graph.h"
+#include "graph_io.h"
+
+// Search-tree nodes visited by the calling thread. Worker threads add
+// theirs to bench_nodes_done when they exit.
+std::atomic<uint64_t> bench_nodes_done{0};
+struct BenchNodeCounter {
+    uint64_t n = 0;
+    ~BenchNodeCounter() { bench_nodes_done += n; }
+};
+thread_local BenchNodeCounter bench_nodes;
+
+#define BK_SEARCH_NODE() (++bench_nodes.n)
+
+#include "clique.h"
+
+// The public engines are single-file programs; each one is compiled into its
+// own namespace so their globals do not collide, and its main goes unused.
+namespace bkd {
+#include "public/algorithms/bronk_kerbosch_degeneracy.cpp"
+}
+namespace bk {
+#include "public/algorithms/bronk_kerbosch.cpp"
+}
+#undef ll
+#undef pb
+
+using namespace std;
+using namespace chrono;
+
+// ---------------------------------------------------------------------
+// Generators. All of them return a simple undirected graph on [0, n) and
+// are deterministic for a given seed.
+
+struct BenchGraph {
+    string name;
+    int n = 0;
+    CSRGraph csr;
+};
+
+using EdgeList = vector<pair<int, int>>;
+
+void finishGraph(BenchGraph& g, EdgeList edges) {
+    vector<EdgeList> parts(1, move(edges));
+    build_csr(g.n, parts, g.csr);
+}
+
+// G(n, p) with p = avg_degree / (n - 1). Pairs are visited in order and the
+// gap to the next edge is drawn from the geometric distribution, so the cost
+// is O(n + m) rather than O(n^2).
+void erdosRenyi(BenchGraph& g, int n, double avg_degree, mt19937_64& rng, EdgeList& edges) {
+    g.n = n;
+    const double p = n > 1 ? min(1.0, avg_degree / (n - 1)) : 0.0;
+    if (p <= 0) return;
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    const double log_q = log(1.0 - p);
+    long long v = 1, w = -1;
+    while (v < n) {
+        const double r = unit(rng);
+        w += 1 + (p < 1 ? (long long)floor(log(1.0 - r) / log_q) : 0);
+        while (w >= v && v < n) {
+            w -= v;
+            ++v;
+        }
+        if (v < n) edges.emplace_back(v, w);
+    }
+}
+
+// R-MAT with the Graph500 quadrant probabilities (0.57, 0.19, 0.19, 0.05):
+// 2^scale vertices and edge_factor * 2^scale edge draws, which gives a
+// skewed, power-law-like degree distribution. Ids are shuffled so hubs are
+// not clustered at the low end.
+void rmat(BenchGraph& g, int scale, int edge_factor, mt19937_64& rng, EdgeList& edges) {
+    const int n = 1 << scale;
+    const long long m = (long long)edge_factor * n;
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<int> label(n);
+    iota(label.begin(), label.end(), 0);
+    shuffle(label.begin(), label.end(), rng);
+    edges.reserve(m);
+    for (long long e = 0; e < m; ++e) {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit) {
+            const double r = unit(rng);
+            if (r < 0.57) continue;
+            if (r < 0.76) v |= 1 << bit;
+            else if (r < 0.95) u |= 1 << bit;
+            else u |= 1 << bit, v |= 1 << bit;
+        }
+        edges.emplace_back(label[u], label[v]);
+    }
+    g.n = n;
+}
+
+// Moon-Moser graph: the complete k-partite graph with parts of size 3. It
+// has the most maximal cliques possible on 3k vertices, 3^k of them.
+void moonMoser(BenchGraph& g, int k, EdgeList& edges) {
+    const int n = 3 * k;
+    for (int u = 0; u < n; ++u) {
+        for (int v = u + 1; v < n; ++v) {
+            if (u / 3 != v / 3) edges.emplace_back(u, v);
+        }
+    }
+    g.n = n;
+}
+
+// G(n, p) background with a clique on `size` random vertices planted in it.
+void plantedClique(BenchGraph& g, int n, double avg_degree, int size, mt19937_64& rng, EdgeList& edges) {
+    erdosRenyi(g, n, avg_degree, rng, edges);
+    vector<int> members(n);
+    iota(members.begin(), members.end(), 0);
+    shuffle(members.begin(), members.end(), rng);
+    members.resize(min(size, n));
+    for (size_t a = 0; a < members.size(); ++a) {
+        for (size_t b = a + 1; b < members.size(); ++b) edges.emplace_back(members[a], members[b]);
+    }
+}
+
+// Builds a graph from a spec such as "er:5000:16", "rmat:12:8", "mm:10" or
+// "planted:5000:16:40". Returns false if the spec is malformed.
+bool generateGraph(const string& spec, uint64_t seed, BenchGraph& g) {
+    vector<string> f;
+    stringstream ss(spec);
+    for (string part; getline(ss, part, ':');) f.push_back(part);
+    auto num = [&](size_t i) { return atof(f[i].c_str()); };
+    mt19937_64 rng(seed ^ hash<string>()(spec));
+    EdgeList edges;
+    g.name = spec;
+    if (f[0] == "er" && f.size() == 3 && num(1) > 0) {
+        erdosRenyi(g, num(1), num(2), rng, edges);
+    } else if (f[0] == "rmat" && f.size() == 3 && num(1) >= 1 && num(1) <= 30) {
+        rmat(g, num(1), num(2), rng, edges);
+    } else if (f[0] == "mm" && f.size() == 2 && num(1) >= 1) {
+        moonMoser(g, num(1), edges);
+    } else if (f[0] == "planted" && f.size() == 4 && num(1) > 0) {
+        plantedClique(g, num(1), num(2), num(3), rng, edges);
+    } else {
+        return false;
+    }
+    finishGraph(g, move(edges));
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Engine adapters. load copies g into the engine's own representation,
+// untimed; run does a full enumeration and reports the maximal cliques with
+// at least two vertices (isolated vertices are left out, as q2 does) and the
+// largest clique size.
+
+struct EngineResult {
+    long long cliques = 0;
+    int largest = 0;
+};
+
+int isolatedVertices(const BenchGraph& g) {
+    int isolated = 0;
+    for (int v = 0; v < g.n; ++v) isolated += g.csr.degree(v) == 0;
+    return isolated;
+}
+
+vector<vector<long long>> adjacencyLists(const BenchGraph& g) {
+    vector<vector<long long>> lists(g.n);
+    for (int v = 0; v < g.n; ++v) lists[v].assign(g.csr[v].begin(), g.csr[v].end());
+    return lists;
+}
+
+EngineResult histogramResult(const CliqueHistogram& histogram) {
+    EngineResult r;
+    const vector<long long> sizes = histogram.sizes();
+    for (size_t s = 2; s < sizes.size(); ++s) {
+        r.cliques += sizes[s];
+        if (sizes[s] > 0) r.largest = s;
+    }
+    return r;
+}
+
+// The q1 and q2 engines read g directly.
+void loadNothing(const BenchGraph&) {}
+
+// q1: one search over the whole vertex set on the sorted-array engine.
+EngineResult runQ1(const BenchGraph& g, int) {
+    CliqueOptions options;
+    options.bitset_threshold = 0;
+    vector<int> P(g.n);
+    iota(P.begin(), P.end(), 0);
+    CliqueHistogram histogram;
+    CliqueEnumerator(g.csr, options).expand({}, P, {}, histogram);
+    return histogramResult(histogram);
+}
+
+// q2: degeneracy order, then every root on the bitset or the array engine.
+EngineResult runQ2(const BenchGraph& g, int threads) {
+    CliqueOptions options;
+    options.threads = threads;
+    CliqueHistogram histogram(threads);
+    CliqueEnumerator(g.csr, options).run(histogram);
+    return histogramResult(histogram);
+}
+
+// Largest clique size as seen by a sink; the public engines only count.
+class LargestSink : public bk::CliqueSink {
+public:
+    size_t largest = 0;
+    void emit(const vector<long long>& clique) override {
+        count++;
+        largest = max(largest, clique.size());
+    }
+};
+
+class LargestDegeneracySink : public bkd::CliqueSink {
+public:
+    size_t largest = 0;
+    void emit(const vector<long long>& clique) override {
+        count++;
+        largest = max(largest, clique.size());
+    }
+};
+
+void loadDegeneracy(const BenchGraph& g) { bkd::adj = adjacencyLists(g); }
+
+// public/algorithms/bronk_kerbosch_degeneracy.cpp
+EngineResult runDegeneracy(const BenchGraph& g, int) {
+    LargestDegeneracySink sink;
+    bkd::sink = &sink;
+    bkd::bronKerboschDegeneracy(bkd::getDegeneracyOrdering(bkd::adj));
+    sink.finish();
+    bkd::sink = nullptr;
+    return {sink.count - isolatedVertices(g), g.csr.entries() ? (int)sink.largest : 0};
+}
+
+void loadComponents(const BenchGraph& g) { bk::adj = adjacencyLists(g); }
+
+// public/algorithms/bronk_kerbosch.cpp: its connected components, largest
+// first, on the worker threads.
+EngineResult runComponents(const BenchGraph& g, int threads) {
+    bk::initialize(g.n);
+    for (int v = 0; v < g.n; ++v) {
+        for (int w : g.csr[v]) bk::unite(v, w);
+    }
+    LargestSink sink;
+    bk::sink = &sink;
+    bk::enumerateComponents(g.n, threads);
+    sink.finish();
+    bk::sink = nullptr;
+    return {sink.count - isolatedVertices(g), g.csr.entries() ? (int)sink.largest : 0};
+}
+
+struct Engine {
+    const char* name;
+    void (*load)(const BenchGraph&);
+    EngineResult (*run)(const BenchGraph&, int);
+};
+
+const Engine engines[] = {
+    {"q1", loadNothing, runQ1},
+    {"q2", loadNothing, runQ2},
+    {"bk_degeneracy", loadDegeneracy, runDegeneracy},
+    {"bk_components", loadComponents, runComponents},
+};
+
+// ---------------------------------------------------------------------
+
+vector<string> splitList(const string& s) {
+    vector<string> out;
+    stringstream ss(s);
+    for (string item; getline(ss, item, ',');) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+string jsonString(const string& s) {
+    string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+int main(int argc, char** argv) {
+    string graph_list = "er:5000:16,rmat:12:8,mm:10,planted:5000:16:40";
+    string engine_list = "q1,q2,bk_degeneracy,bk_components";
+    const char* out_path = nullptr;
+    int reps = 3;
+    int threads = 1;
+    uint64_t seed = 1;
+    bool usage_error = false;
+    for (int a = 1; a < argc; ++a) {
+        if (strcmp(argv[a], "--graphs") == 0 && a + 1 < argc) {
+            graph_list = argv[++a];
+        } else if (strcmp(argv[a], "--engines") == 0 && a + 1 < argc) {
+            engine_list = argv[++a];
+        } else if (strcmp(argv[a], "--reps") == 0 && a + 1 < argc) {
+            reps = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "--threads") == 0 && a + 1 < argc) {
+            threads = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "--seed") == 0 && a + 1 < argc) {
+            seed = strtoull(argv[++a], nullptr, 10);
+        } else if (strcmp(argv[a], "--out") == 0 && a + 1 < argc) {
+            out_path = argv[++a];
+        } else {
+            usage_error = true;
+        }
+    }
+
+    vector<const Engine*> selected;
+    for (const string& name : splitList(engine_list)) {
+        const Engine* found = nullptr;
+        for (const Engine& e : engines) {
+            if (name == e.name) found = &e;
+        }
+        if (!found) usage_error = true;
+        selected.push_back(found);
+    }
+    if (usage_error || reps < 1 || threads < 0) {
+        cerr << "Usage: " << argv[0] << " [--graphs SPEC,...] [--engines NAME,...] [--reps R]"
+             << " [--threads N] [--seed S] [--out file.json]\n"
+             << "  graphs:  er:N:AVG_DEGREE  rmat:SCALE:EDGE_FACTOR  mm:K  planted:N:AVG_DEGREE:SIZE\n"
+             << "  engines: q1 q2 bk_degeneracy bk_components" << endl;
+        return 1;
+    }
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    vector<BenchGraph> graphs;
+    for (const string& spec : splitList(graph_list)) {
+        graphs.emplace_back();
+        if (!generateGraph(spec, seed, graphs.back())) {
+            cerr << "Bad graph spec " << spec << endl;
+            return 1;
+        }
+    }
+
+    ofstream out_file;
+    if (out_path) {
+        out_file.open(out_path);
+        if (!out_file) {
+            cerr << "Cannot write " << out_path << endl;
+            return 1;
+        }
+    }
+    ostream& out = out_path ? out_file : cout;
+    out << "{\n  \"isa\": " << jsonString(set_ops_isa()) << ",\n  \"threads\": " << threads
+        << ",\n  \"reps\": " << reps << ",\n  \"seed\": " << seed << ",\n  \"results\": [";
+
+    bool first = true;
+    bool mismatch = false;
+    for (const BenchGraph& g : graphs) {
+        const string& spec = g.name;
+        long long expected = -1;
+        for (const Engine* engine : selected) {
+            // Best of `reps` runs; nodes and cliques are the same every run.
+            double best_ms = numeric_limits<double>::infinity();
+            uint64_t nodes = 0;
+            EngineResult result;
+            engine->load(g);
+            for (int rep = 0; rep < reps; ++rep) {
+                bench_nodes.n = 0;
+                bench_nodes_done = 0;
+                const auto t0 = high_resolution_clock::now();
+                result = engine->run(g, threads);
+                const auto t1 = high_resolution_clock::now();
+                nodes = bench_nodes.n + bench_nodes_done;
+                best_ms = min(best_ms, duration<double, milli>(t1 - t0).count());
+            }
+            if (expected == -1) expected = result.cliques;
+            if (result.cliques != expected) {
+                cerr << engine->name << " found " << result.cliques << " cliques on " << spec
+                     << ", expected " << expected << endl;
+                mismatch = true;
+            }
+            out << (first ? "\n" : ",\n") << "    {\"graph\": " << jsonString(spec) << ", \"n\": " << g.n
+                << ", \"m\": " << g.csr.edges() << ", \"engine\": " << jsonString(engine->name)
+                << ", \"time_ms\": " << fixed << setprecision(3) << best_ms << ", \"nodes\": " << nodes
+                << ", \"cliques\": " << result.cliques << ", \"max_clique\": " << result.largest
+                << ", \"cliques_per_sec\": " << setprecision(0)
+                << (best_ms > 0 ? result.cliques * 1000.0 / best_ms : 0.0) << "}";
+            out.unsetf(ios::floatfield);
+            first = false;
+            cerr << spec << " " << engine->name << ": " << best_ms << " ms" << endl;
+        }
+    }
+    out << "\n  ]\n}\n";
+    return mismatch ? 2 : 0;
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "graph_io.h"
+
+// Restart points for long enumerations. A run over the roots at positions
+// [first, last) of the degeneracy order finishes roots out of order, but at
+// any time some prefix [first, done) of them is finished, and the histogram
+// of their cliques (plus a largest one) is all the state there is, since
+// each maximal clique belongs to exactly one root. Resuming runs
+// [done, last) and adds on, so the final histogram is the one of an
+// uninterrupted run.
+//
+// The checkpoint is only valid for the same graph, order, root range and
+// minimum size; load_checkpoint's caller compares the fingerprint.
+
+struct Checkpoint {
+    // Fingerprint of the run.
+    uint64_t n = 0;
+    uint64_t entries = 0;
+    uint64_t checksum = 0;  // snapshot_checksum over neighbours, then order
+    int first = 0, last = 0;
+    int min_size = 0;
+    // Progress.
+    int done = 0;
+    std::vector<long long> sizes;  // sizes[s]: maximal cliques of size s so far
+    std::vector<int> largest;      // a largest clique so far, if kept
+
+    // Fills the fingerprint for enumerating [first, last) of order on graph.
+    void fingerprint(const CSRGraph& graph, const std::vector<int>& order, int first_root, int last_root,
+                     int min_clique_size) {
+        n = graph.size();
+        entries = graph.entries();
+        checksum = snapshot_checksum(reinterpret_cast<const char*>(graph.neighbour_data()), entries * sizeof(int));
+        checksum = snapshot_checksum(reinterpret_cast<const char*>(order.data()), order.size() * sizeof(int), checksum);
+        first = done = first_root;
+        last = last_root;
+        min_size = min_clique_size;
+    }
+
+    bool same_run(const Checkpoint& other) const {
+        return n == other.n && entries == other.entries && checksum == other.checksum && first == other.first &&
+               last == other.last && min_size == other.min_size;
+    }
+};
+
+// Text format:
+//   bk-checkpoint 1
+//   n <n> entries <m> checksum <hex> range <first> <last> min-size <k>
+//   done <position>
+//   sizes <count> then "<size> <cliques>" for each nonzero size
+//   largest <k> <v1> ... <vk>
+// Written to filename.tmp and renamed over filename, so a kill mid-write
+// leaves the previous checkpoint in place.
+inline bool save_checkpoint(const std::string& filename, const Checkpoint& cp) {
+    const std::string tmp = filename + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) return false;
+        out << "bk-checkpoint 1\n";
+        out << "n " << cp.n << " entries " << cp.entries << " checksum " << std::hex << cp.checksum << std::dec
+            << " range " << cp.first << " " << cp.last << " min-size " << cp.min_size << "\n";
+        out << "done " << cp.done << "\n";
+        int nonzero = 0;
+        for (long long c : cp.sizes) nonzero += c != 0;
+        out << "sizes " << nonzero << "\n";
+        for (size_t s = 0; s < cp.sizes.size(); ++s) {
+            if (cp.sizes[s] != 0) out << s << " " << cp.sizes[s] << "\n";
+        }
+        out << "largest " << cp.largest.size();
+        for (int v : cp.largest) out << " " << v;
+        out << "\n";
+        out.flush();
+        if (!out) return false;
+    }
+    return std::rename(tmp.c_str(), filename.c_str()) == 0;
+}
+
+inline bool load_checkpoint(const std::string& filename, Checkpoint& cp) {
+    std::ifstream in(filename);
+    std::string word;
+    int version;
+    if (!(in >> word >> version) || word != "bk-checkpoint" || version != 1) return false;
+    if (!(in >> word >> cp.n >> word >> cp.entries >> word >> std::hex >> cp.checksum >> std::dec >> word >>
+          cp.first >> cp.last >> word >> cp.min_size)) {
+        return false;
+    }
+    int nonzero;
+    if (!(in >> word >> cp.done) || word != "done" || cp.done < cp.first || cp.done > cp.last) return false;
+    if (!(in >> word >> nonzero) || word != "sizes" || nonzero < 0) return false;
+    cp.sizes.clear();
+    for (int i = 0; i < nonzero; ++i) {
+        long long size, count;
+        if (!(in >> size >> count) || size < 0 || size > (long long)cp.n) return false;
+        if ((long long)cp.sizes.size() <= size) cp.sizes.resize(size + 1, 0);
+        cp.sizes[size] = count;
+    }
+    long long k;
+    if (!(in >> word >> k) || word != "largest" || k < 0 || k > (long long)cp.n) return false;
+    cp.largest.resize(k);
+    for (int& v : cp.largest) {
+        if (!(in >> v)) return false;
+    }
+    return true;
+}
+
+// Visitor for a checkpointed CliqueEnumerator::run over [cp.done, cp.last):
+// keeps the cliques of the root each worker is on, and when a root is done
+// folds them into cp once every root before it is done too, so cp always
+// describes a finished prefix. Saves cp to path whenever `every` seconds
+// have passed since the last save; finish() saves the final state. With
+// keep_largest, cp.largest is kept as well (sorted).
+template <bool keep_largest>
+class CheckpointVisitor {
+    struct RootResult {
+        std::vector<long long> sizes;
+        std::vector<int> largest;
+    };
+    Checkpoint& cp;
+    std::string path;
+    std::chrono::duration<double> every;
+    std::chrono::steady_clock::time_point saved;
+    std::vector<RootResult> current;
+    // Finished roots past the prefix, by position.
+    std::map<int, RootResult> finished;
+    std::mutex m;
+    bool ok = true;
+
+    void fold(RootResult& r) {
+        if (cp.sizes.size() < r.sizes.size()) cp.sizes.resize(r.sizes.size(), 0);
+        for (size_t s = 0; s < r.sizes.size(); ++s) cp.sizes[s] += r.sizes[s];
+        if (r.largest.size() > cp.largest.size()) cp.largest = std::move(r.largest);
+        ++cp.done;
+    }
+
+public:
+    static constexpr bool size_only = !keep_largest;
+
+    CheckpointVisitor(Checkpoint& checkpoint, std::string path_, double every_seconds, int workers)
+        : cp(checkpoint), path(std::move(path_)), every(every_seconds), saved(std::chrono::steady_clock::now()),
+          current(std::max(1, workers)) {}
+
+    void operator()(int worker, const int* clique, int size) {
+        RootResult& r = current[worker];
+        if ((int)r.sizes.size() <= size) r.sizes.resize(size + 1, 0);
+        r.sizes[size]++;
+        if (keep_largest && size > (int)r.largest.size()) r.largest.assign(clique, clique + size);
+    }
+
+    void root_done(int worker, int i) {
+        RootResult& r = current[worker];
+        std::sort(r.largest.begin(), r.largest.end());
+        std::lock_guard<std::mutex> lock(m);
+        if (i != cp.done) {
+            finished.emplace(i, std::move(r));
+        } else {
+            fold(r);
+            for (auto it = finished.begin(); it != finished.end() && it->first == cp.done; it = finished.erase(it)) {
+                fold(it->second);
+            }
+        }
+        r = RootResult();
+        if (std::chrono::steady_clock::now() - saved >= every) {
+            ok &= save_checkpoint(path, cp);
+            saved = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Saves the state after the run; false if this or any earlier save
+    // failed.
+    bool finish() {
+        std::lock_guard<std::mutex> lock(m);
+        ok &= save_checkpoint(path, cp);
+        return ok;
+    }
+};
@@ -0,0 +1,1006 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "graph.h"
+#include "set_ops.h"
+
+// Maximal-clique enumeration over a CSRGraph. Nothing here is global: a
+// CliqueEnumerator only reads its graph, so any number of them (on the same
+// or different graphs) can run side by side in one process.
+//
+// Cliques are handed to a visitor, any callable as
+//
+//   visit(int worker, const int* clique, int size)
+//
+// where worker is the index of the calling thread in [0, threads). Calls
+// from different workers may be concurrent; calls with the same worker
+// never are, so per-worker state needs no locking (see CliqueHistogram).
+// The clique array is only valid during the call.
+//
+// A visitor that only looks at sizes can declare
+//
+//   static constexpr bool size_only = true;
+//
+// The engines then keep just the depth of the search instead of the clique
+// itself, and pass nullptr for the clique.
+
+// Called once per search-tree node; the benchmark defines it to count them.
+#ifndef BK_SEARCH_NODE
+#define BK_SEARCH_NODE()
+#endif
+
+// Search-tree counters (SearchStats) are only collected when built with
+// -DCLIQUE_STATS; otherwise every CLIQUE_STAT statement compiles away.
+#ifdef CLIQUE_STATS
+#define CLIQUE_STAT(...) __VA_ARGS__
+#else
+#define CLIQUE_STAT(...)
+#endif
+
+// Batagelj-Zaversnik bucket peel. Returns a degeneracy order; if core is
+// given it receives every vertex's core number.
+inline std::vector<int> core_decomposition(const CSRGraph& adj, std::vector<int>* core = nullptr) {
+    const int n = adj.size();
+    std::vector<int> degree(n);
+    for (int i = 0; i < n; ++i) degree[i] = adj[i].size();
+
+    int max_degree = n ? *std::max_element(degree.begin(), degree.end()) : 0;
+    std::vector<int> bin(max_degree + 2, 0);
+    for (int d : degree) bin[d + 1]++;
+    for (int d = 0; d <= max_degree; ++d) bin[d + 1] += bin[d];
+
+    std::vector<int> vert(n), pos_arr(n);
+    for (int i = 0; i < n; ++i) {
+        pos_arr[i] = bin[degree[i]]++;
+        vert[pos_arr[i]] = i;
+    }
+
+    for (int d = max_degree; d >= 1; --d) bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    std::vector<int> order;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        int v = vert[i];
+        order.push_back(v);
+        for (int u : adj[v]) {
+            if (degree[u] > degree[v]) {
+                int du = degree[u];
+                int pu = pos_arr[u];
+                int pw = bin[du];
+                int w = vert[pw];
+                if (u != w) {
+                    pos_arr[u] = pw;
+                    pos_arr[w] = pu;
+                    vert[pu] = w;
+                    vert[pw] = u;
+                }
+                bin[du]++;
+                degree[u]--;
+            }
+        }
+    }
+    if (core) *core = std::move(degree);
+    return order;
+}
+
+// Calls fn(t, lo, hi) on `threads` contiguous slices of [0, count). Inputs
+// too small to repay starting threads run as a single slice on the caller.
+template <class Fn>
+void parallel_for(size_t count, int threads, Fn fn) {
+    const size_t min_slice = 4096;
+    threads = std::max<size_t>(1, std::min<size_t>(threads, count / min_slice));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(fn, t, count * t / threads, count * (t + 1) / threads);
+    }
+    fn(0, 0, count / threads);
+    for (auto& w : workers) w.join();
+}
+
+// Level-synchronous parallel peel. Level k repeatedly removes, as one
+// batch, every remaining vertex whose degree is at most k; neighbours are
+// decremented with atomics, and the thread that takes a neighbour from k + 1
+// to k queues it for the next batch. Every batch is sorted by vertex id, so
+// the order is the same for any thread count, and each vertex has at most k
+// neighbours later in it, which makes it a valid degeneracy order.
+//
+// Levels start from degree buckets rather than a scan of what remains:
+// every remaining vertex has an entry in the bucket for its current degree
+// (entries go stale when it is removed or drops lower), and a vertex whose
+// degree drops during a level without reaching the batch is re-entered
+// once, at its degree after the level. Finding all levels then costs
+// O(n + m) in total instead of a pass over the remaining vertices per level.
+inline std::vector<int> parallel_core_decomposition(const CSRGraph& adj, int threads,
+                                                    std::vector<int>* core = nullptr) {
+    const int n = adj.size();
+    threads = std::max(1, threads);
+    int max_degree = 0;
+    for (int v = 0; v < n; ++v) max_degree = std::max<int>(max_degree, adj.degree(v));
+    // The remaining degree and the last level (plus one) that queued the
+    // vertex in moved, side by side so a decrement touches one cache line.
+    struct Counter {
+        std::atomic<int> degree;
+        std::atomic<int> moved_at;
+    };
+    std::vector<Counter> state(n);
+    std::vector<char> removed(n, 0);
+    std::vector<std::vector<int>> buckets(max_degree + 1);
+    std::vector<std::vector<int>> found(threads), moved(threads);
+    std::vector<int> frontier, order;
+    if (core) core->assign(n, 0);
+    order.reserve(n);
+    parallel_for(n, threads, [&](int, size_t lo, size_t hi) {
+        for (size_t v = lo; v < hi; ++v) {
+            state[v].degree.store(adj[v].size(), std::memory_order_relaxed);
+            state[v].moved_at.store(0, std::memory_order_relaxed);
+        }
+    });
+    for (int v = 0; v < n; ++v) buckets[adj.degree(v)].push_back(v);
+
+    // Concatenates the per-thread lists in thread order.
+    auto gather = [&](std::vector<int>& out) {
+        out.clear();
+        for (auto& part : found) {
+            out.insert(out.end(), part.begin(), part.end());
+            part.clear();
+        }
+    };
+
+    for (int k = 0; (int)order.size() < n; ++k) {
+        // Level k starts with the vertices still at degree k; none is lower.
+        frontier.clear();
+        for (int v : buckets[k]) {
+            if (!removed[v] && state[v].degree.load(std::memory_order_relaxed) == k) frontier.push_back(v);
+        }
+        std::vector<int>().swap(buckets[k]);
+        std::sort(frontier.begin(), frontier.end());
+
+        while (!frontier.empty()) {
+            for (int v : frontier) {
+                removed[v] = 1;
+                order.push_back(v);
+                if (core) (*core)[v] = k;
+            }
+            parallel_for(frontier.size(), threads, [&](int t, size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    for (int u : adj[frontier[i]]) {
+                        if (removed[u]) continue;
+                        Counter& c = state[u];
+                        const int before = c.degree.fetch_sub(1, std::memory_order_relaxed);
+                        if (before == k + 1) {
+                            found[t].push_back(u);
+                        } else if (before > k + 1 && c.moved_at.load(std::memory_order_relaxed) != k + 1 &&
+                                   c.moved_at.exchange(k + 1, std::memory_order_relaxed) != k + 1) {
+                            moved[t].push_back(u);
+                        }
+                    }
+                }
+            });
+            gather(frontier);
+            std::sort(frontier.begin(), frontier.end());
+        }
+
+        // Re-bucket the vertices this level lowered but did not remove.
+        for (int t = 0; t < threads; ++t) {
+            for (int u : moved[t]) {
+                if (!removed[u]) buckets[state[u].degree.load(std::memory_order_relaxed)].push_back(u);
+            }
+            moved[t].clear();
+        }
+    }
+    return order;
+}
+
+// Whether Visitor declares size_only = true.
+template <class Visitor, class = void>
+struct visits_size_only : std::false_type {};
+template <class Visitor>
+struct visits_size_only<Visitor, std::void_t<decltype(Visitor::size_only)>>
+    : std::integral_constant<bool, Visitor::size_only> {};
+
+// Whether Visitor has root_done(worker, i). run() then calls it on the worker
+// that searched the root at position i of the order, after the last of that
+// root's cliques, for every root it covers (cliques or not).
+template <class Visitor, class = void>
+struct visits_root_done : std::false_type {};
+template <class Visitor>
+struct visits_root_done<Visitor, std::void_t<decltype(std::declval<Visitor&>().root_done(0, 0))>>
+    : std::true_type {};
+
+// How each search node picks its pivot u (the node branches on P \ N(u)).
+enum class PivotRule {
+    Tomita,  // the u in P u X whose neighbourhood covers most of P
+    First,   // the smallest vertex of P u X
+    Middle,  // the middle vertex of P u X
+};
+
+struct CliqueOptions {
+    // Worker threads for run(); expand() always runs on the caller.
+    int threads = 1;
+    // Searches whose P u X has up to this many vertices run on the bitset
+    // engine (0 disables it).
+    int bitset_threshold = 1024;
+    PivotRule pivot = PivotRule::Tomita;
+    // Only cliques of at least this many vertices are visited. The search
+    // then drops every vertex outside the (min_size - 1)-core, which can
+    // neither be in such a clique nor extend one, and cuts every branch
+    // where |R| + |P| < min_size.
+    int min_size = 0;
+};
+
+// What the search did, summed over all workers. Depth is the size of R at
+// a node, so the children of a root vertex are at depth 2.
+struct SearchStats {
+    std::vector<uint64_t> nodes_by_depth;
+    // Sorted-set intersections and differences (pivot scoring included),
+    // and the total length of their inputs.
+    uint64_t set_ops = 0, set_op_elements = 0;
+    // 64-bit words combined by the bitset engine.
+    uint64_t bitset_words = 0;
+    // Pivot effectiveness: over all inner nodes, |P| against the branches
+    // |P \ N(u)| actually taken.
+    uint64_t pivot_p = 0, pivot_branches = 0;
+    // Leaves: maximal cliques reported, and dead ends where P ran out but X
+    // did not (R was not maximal).
+    uint64_t maximal = 0, dead_ends = 0;
+
+    void node(int depth) {
+        if ((int)nodes_by_depth.size() <= depth) nodes_by_depth.resize(depth + 1, 0);
+        nodes_by_depth[depth]++;
+    }
+
+    void set_op(size_t na, size_t nb) {
+        set_ops++;
+        set_op_elements += na + nb;
+    }
+
+    void merge(const SearchStats& o) {
+        if (nodes_by_depth.size() < o.nodes_by_depth.size()) nodes_by_depth.resize(o.nodes_by_depth.size(), 0);
+        for (size_t d = 0; d < o.nodes_by_depth.size(); ++d) nodes_by_depth[d] += o.nodes_by_depth[d];
+        set_ops += o.set_ops;
+        set_op_elements += o.set_op_elements;
+        bitset_words += o.bitset_words;
+        pivot_p += o.pivot_p;
+        pivot_branches += o.pivot_branches;
+        maximal += o.maximal;
+        dead_ends += o.dead_ends;
+    }
+
+    void write_json(std::ostream& out) const {
+        uint64_t nodes = 0;
+        for (uint64_t c : nodes_by_depth) nodes += c;
+        out << "{\n  \"nodes\": " << nodes << ",\n  \"nodes_by_depth\": [";
+        for (size_t d = 0; d < nodes_by_depth.size(); ++d) out << (d ? ", " : "") << nodes_by_depth[d];
+        out << "],\n  \"set_ops\": " << set_ops << ",\n  \"set_op_elements\": " << set_op_elements
+            << ",\n  \"bitset_words\": " << bitset_words << ",\n  \"pivot_p\": " << pivot_p
+            << ",\n  \"pivot_branches\": " << pivot_branches << ",\n  \"pivot_branch_ratio\": "
+            << (pivot_p ? (double)pivot_branches / pivot_p : 0.0) << ",\n  \"maximal\": " << maximal
+            << ",\n  \"dead_ends\": " << dead_ends << "\n}\n";
+    }
+};
+
+namespace clique_detail {
+
+// One node of the depth-first search. P, X and the pivot candidates live in
+// the worker's arena; X is sized to also take every vertex moved over from P.
+struct Frame {
+    int* P;
+    int* X;
+    int* cand;
+    int np, nx, ncand, next;
+    Arena::Mark mark;
+};
+
+// Per-thread scratch space reused from root to root, so that enumeration
+// stops allocating once the buffers have grown to the largest root.
+struct Workspace {
+    Arena arena;
+    std::vector<Frame> frames;
+    // The clique of the current node, or only its size (depth) when the
+    // visitor does not need the members.
+    std::vector<int> R;
+    int depth = 0;
+    std::vector<int> rootP, rootX;
+    std::vector<int> local, scan;
+    std::vector<uint64_t> rows, bits;
+    SearchStats stats;
+    // Running totals of search nodes and maximal cliques, for root profiles,
+    // and how much of them has been published to a CliqueProgress.
+    uint64_t nodes = 0, cliques = 0, roots = 0;
+    uint64_t published_nodes = 0, published_cliques = 0, published_roots = 0;
+    // Set by expand(): the search's top-level branches count as roots.
+    bool top_level_roots = false;
+};
+
+// Nodes a worker visits between two progress updates.
+constexpr uint64_t kProgressBatch = 1024;
+
+// Work-stealing scheduler over root indices. Every worker owns a contiguous
+// range of the degeneracy order and takes roots from its front; a worker that
+// runs dry steals the upper half of another worker's remaining range.
+class RootScheduler {
+    struct Range {
+        std::mutex m;
+        int lo = 0, hi = 0;
+    };
+    std::vector<Range> ranges;
+
+public:
+    RootScheduler(int n, int threads) : ranges(threads) {
+        for (int t = 0; t < threads; ++t) {
+            ranges[t].lo = (long long)n * t / threads;
+            ranges[t].hi = (long long)n * (t + 1) / threads;
+        }
+    }
+
+    // Returns the next root for worker t, or -1 once no work is left.
+    int next(int t) {
+        {
+            std::lock_guard<std::mutex> lock(ranges[t].m);
+            if (ranges[t].lo < ranges[t].hi) return ranges[t].lo++;
+        }
+        const int threads = ranges.size();
+        for (int k = 1; k < threads; ++k) {
+            Range& victim = ranges[(t + k) % threads];
+            int lo, hi;
+            {
+                std::lock_guard<std::mutex> lock(victim.m);
+                if (victim.lo >= victim.hi) continue;
+                int mid = victim.lo + (victim.hi - victim.lo) / 2;
+                lo = mid;
+                hi = victim.hi;
+                victim.hi = mid;
+            }
+            std::lock_guard<std::mutex> lock(ranges[t].m);
+            ranges[t].lo = lo + 1;
+            ranges[t].hi = hi;
+            return lo;
+        }
+        return -1;
+    }
+};
+
+}  // namespace clique_detail
+
+// Live counters an enumeration publishes for progress reporting. Workers
+// add their node and clique counts in batches, so a reader sees values at
+// most a batch behind; everything is relaxed and only meant for display.
+struct CliqueProgress {
+    // Roots of run(), or top-level branches of expand().
+    std::atomic<uint64_t> roots_done{0}, roots_total{0};
+    std::atomic<uint64_t> nodes{0}, cliques{0};
+    // Size of R at the node most recently published by any worker.
+    std::atomic<int> depth{0};
+};
+
+// Cost of one root of the degeneracy order, as measured by run().
+struct RootCost {
+    int vertex = -1;
+    int p = 0, x = 0;
+    uint64_t nodes = 0, cliques = 0;
+    double ms = 0;
+};
+
+// Enumerates the maximal cliques of one graph. run() covers the whole graph
+// root by root in degeneracy order (Eppstein-Loffler-Strash); expand() runs
+// a single Bron-Kerbosch search from given R, P and X.
+class CliqueEnumerator {
+    using Frame = clique_detail::Frame;
+    using Workspace = clique_detail::Workspace;
+
+    const CSRGraph& adj;
+    CliqueOptions opts;
+    std::vector<int> order_;
+    std::vector<int> pos;
+    // order_[i] == i for all i, as on a graph relabeled by its own order.
+    bool identity_order = false;
+    // alive[v]: v is in the (min_size - 1)-core; empty when nothing is pruned.
+    std::vector<char> alive;
+    SearchStats stats_;
+    std::mutex stats_mutex;
+    bool profile_roots = false;
+    std::vector<RootCost> root_costs;
+    int profile_first = 0;
+    std::vector<double> cost_hint;
+    CliqueProgress* progress = nullptr;
+
+public:
+    explicit CliqueEnumerator(const CSRGraph& graph, CliqueOptions options = {})
+        : adj(graph), opts(options) {
+        opts.threads = std::max(1, opts.threads);
+    }
+
+    const CliqueOptions& options() const { return opts; }
+
+    // Counters of every search run so far; all zero unless built with
+    // CLIQUE_STATS.
+    const SearchStats& stats() const { return stats_; }
+
+    // When on, run() times every root it searches; root_profile()[i] then
+    // describes the root at position root_profile_first() + i of order(),
+    // for the roots of the last run.
+    void set_root_profiling(bool on) { profile_roots = on; }
+    const std::vector<RootCost>& root_profile() const { return root_costs; }
+    int root_profile_first() const { return profile_first; }
+
+    // Publishes live counters to *p (which must outlive the runs) from now on.
+    void set_progress(CliqueProgress* p) { progress = p; }
+
+    // Expected cost of every root, indexed by vertex (e.g. the ms column of
+    // an earlier root profile). A parallel run() then deals the roots out
+    // most expensive first, spread evenly over the workers.
+    void set_cost_hint(std::vector<double> cost_by_vertex) { cost_hint = std::move(cost_by_vertex); }
+
+    // Uses the given degeneracy order (e.g. one stored in a snapshot)
+    // instead of computing it. With a min_size above 2 the core pruning is
+    // set up here too, from core bounds read off the order.
+    void set_order(std::vector<int> order) {
+        order_ = std::move(order);
+        pos.assign(adj.size(), 0);
+        identity_order = true;
+        for (int i = 0; i < (int)order_.size(); ++i) {
+            pos[order_[i]] = i;
+            identity_order &= order_[i] == i;
+        }
+        prune_to_core();
+    }
+
+    // The degeneracy order run() follows, computed on first use.
+    const std::vector<int>& order() {
+        if ((int)order_.size() != adj.size()) {
+            set_order(opts.threads > 1 ? parallel_core_decomposition(adj, opts.threads) : core_decomposition(adj));
+        }
+        return order_;
+    }
+
+    // Visits every maximal clique of the graph, isolated vertices included
+    // as cliques of size 1, using options().threads workers.
+    template <class Visitor>
+    void run(Visitor& visit) { run(visit, 0, adj.size()); }
+
+    // Visits the maximal cliques whose earliest vertex in order() is at a
+    // position in [first, last). Runs over disjoint ranges split the
+    // enumeration exactly.
+    template <class Visitor>
+    void run(Visitor& visit, int first, int last) {
+        order();
+        prune_to_core();
+        const int threads = opts.threads;
+        if (profile_roots) {
+            profile_first = first;
+            root_costs.assign(last - first, RootCost());
+        }
+        if (progress) progress->roots_total.store(last - first, std::memory_order_relaxed);
+        if (threads == 1) {
+            Workspace ws;
+            for (int i = first; i < last; ++i) run_root(i, ws, 0, visit);
+            publish(ws, 0);
+            CLIQUE_STAT(collect(ws));
+            return;
+        }
+        const std::vector<int> schedule = hinted_schedule(threads, first, last);
+        clique_detail::RootScheduler scheduler(last - first, threads);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                Workspace ws;
+                for (int i = scheduler.next(t); i != -1; i = scheduler.next(t)) {
+                    run_root(schedule.empty() ? first + i : schedule[i], ws, t, visit);
+                }
+                publish(ws, 0);
+                CLIQUE_STAT(collect(ws));
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+
+    // Visits the maximal cliques that extend R with vertices of P and no
+    // vertex of X, on the calling thread as worker 0. P and X must be sorted
+    // and disjoint, and every vertex in them adjacent to all of R.
+    template <class Visitor>
+    void expand(const std::vector<int>& R, const std::vector<int>& P, const std::vector<int>& X,
+                Visitor& visit) {
+        Workspace ws;
+        if (!visits_size_only<Visitor>::value) ws.R = R;
+        ws.depth = R.size();
+        ws.top_level_roots = true;
+        prune_to_core();
+        if (!alive.empty()) {
+            ws.rootP.clear();
+            ws.rootX.clear();
+            for (int v : P) if (alive[v]) ws.rootP.push_back(v);
+            for (int v : X) if (alive[v]) ws.rootX.push_back(v);
+            search(ws.rootP, ws.rootX, ws, 0, visit);
+        } else {
+            search(P, X, ws, 0, visit);
+        }
+        publish(ws, R.size());
+        CLIQUE_STAT(collect(ws));
+    }
+
+private:
+    // Fills alive for a min_size above 2; below that the core bound prunes
+    // nothing the branch cut would not. With an order set, the core number
+    // of the vertex at position i is bounded by the most later neighbours
+    // any vertex up to i has (the first vertex of a k-core in the order has
+    // k later neighbours), which is exact for a peel order and costs one
+    // pass over the edges. Without one (expand() alone), cores are computed.
+    void prune_to_core() {
+        const int n = adj.size();
+        if (opts.min_size <= 2 || (int)alive.size() == n) return;
+        std::vector<int> core;
+        if ((int)order_.size() == n) {
+            core.resize(n);
+            int bound = 0;
+            for (int i = 0; i < n; ++i) {
+                int later = 0;
+                for (int w : adj[order_[i]]) later += pos[w] > i;
+                bound = std::max(bound, later);
+                core[order_[i]] = bound;
+            }
+        } else if (opts.threads > 1) {
+            parallel_core_decomposition(adj, opts.threads, &core);
+        } else {
+            core_decomposition(adj, &core);
+        }
+        alive.assign(n, 0);
+        for (int v = 0; v < n; ++v) alive[v] = core[v] >= opts.min_size - 1;
+    }
+
+    void collect(const Workspace& ws) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats_.merge(ws.stats);
+    }
+
+    // Root positions for the scheduler's slots, or empty to go in order.
+    // Roots are sorted by hinted cost and dealt round-robin, so every
+    // worker's range starts with its share of the expensive roots and the
+    // cheap tail is what gets stolen.
+    std::vector<int> hinted_schedule(int threads, int first, int last) const {
+        if (cost_hint.size() != order_.size()) return {};
+        const int n = last - first;
+        std::vector<int> by_cost(n);
+        for (int i = 0; i < n; ++i) by_cost[i] = first + i;
+        std::stable_sort(by_cost.begin(), by_cost.end(),
+                         [&](int a, int b) { return cost_hint[order_[a]] > cost_hint[order_[b]]; });
+        std::vector<int> schedule;
+        schedule.reserve(n);
+        for (int t = 0; t < threads; ++t) {
+            for (int j = t; j < n; j += threads) schedule.push_back(by_cost[j]);
+        }
+        return schedule;
+    }
+
+    // Adds the worker's unpublished counts to the progress counters.
+    void publish(Workspace& ws, int depth) {
+        if (!progress) return;
+        progress->nodes.fetch_add(ws.nodes - ws.published_nodes, std::memory_order_relaxed);
+        progress->cliques.fetch_add(ws.cliques - ws.published_cliques, std::memory_order_relaxed);
+        if (!ws.top_level_roots) progress->roots_done.fetch_add(ws.roots - ws.published_roots, std::memory_order_relaxed);
+        progress->depth.store(depth, std::memory_order_relaxed);
+        ws.published_nodes = ws.nodes;
+        ws.published_cliques = ws.cliques;
+        ws.published_roots = ws.roots;
+    }
+
+    // Called on every node; publishes once per kProgressBatch nodes.
+    void tick(Workspace& ws, int depth) {
+        if (progress && ws.nodes - ws.published_nodes >= clique_detail::kProgressBatch) publish(ws, depth);
+    }
+
+    // expand() reports its top-level branches as roots: `done` of `total`.
+    void top_level(const Workspace& ws, uint64_t done, uint64_t total) {
+        if (!progress || !ws.top_level_roots) return;
+        progress->roots_done.store(done, std::memory_order_relaxed);
+        progress->roots_total.store(total, std::memory_order_relaxed);
+    }
+
+    template <class Visitor>
+    void run_root(int i, Workspace& ws, int worker, Visitor& visit) {
+        if (!profile_roots) {
+            expand_root(i, ws, worker, visit);
+        } else {
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t nodes = ws.nodes, cliques = ws.cliques;
+            expand_root(i, ws, worker, visit);
+            RootCost& cost = root_costs[i - profile_first];
+            cost.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            cost.vertex = order_[i];
+            cost.p = ws.rootP.size();
+            cost.x = ws.rootX.size();
+            cost.nodes = ws.nodes - nodes;
+            cost.cliques = ws.cliques - cliques;
+        }
+        ws.roots++;
+        tick(ws, 1);
+        if constexpr (visits_root_done<Visitor>::value) visit.root_done(worker, i);
+    }
+
+    // Runs BK for the root at position i of the degeneracy order: P holds the
+    // neighbours that come later in the order, X the ones that come earlier.
+    // Under the identity order these are just the two halves of the sorted
+    // neighbour list around i.
+    template <class Visitor>
+    void expand_root(int i, Workspace& ws, int worker, Visitor& visit) {
+        const int v_i = order_[i];
+        std::vector<int>& P = ws.rootP;
+        std::vector<int>& X = ws.rootX;
+        const bool pruned = !alive.empty();
+        if (identity_order && !pruned) {
+            const auto& nv = adj[v_i];
+            const int* split = std::upper_bound(nv.begin(), nv.end(), v_i);
+            X.assign(nv.begin(), split);
+            P.assign(split, nv.end());
+        } else {
+            P.clear();
+            X.clear();
+            if (pruned && !alive[v_i]) return;
+            for (int w : adj[v_i]) {
+                if (pruned && !alive[w]) continue;
+                if (pos[w] > i) P.push_back(w);
+                else X.push_back(w);
+            }
+            std::sort(P.begin(), P.end());
+            std::sort(X.begin(), X.end());
+        }
+        if (!visits_size_only<Visitor>::value) ws.R.assign(1, v_i);
+        ws.depth = 1;
+        search(P, X, ws, worker, visit);
+    }
+
+    template <class Visitor>
+    void search(const std::vector<int>& P, const std::vector<int>& X, Workspace& ws, int worker,
+                Visitor& visit) {
+        if (ws.depth + (int)P.size() < opts.min_size) return;
+        const size_t k = P.size() + X.size();
+        if (k > 0 && k <= (size_t)opts.bitset_threshold) {
+            search_bitset(P, X, ws, worker, visit);
+        } else {
+            search_sets(P, X, ws, worker, visit);
+        }
+    }
+
+    int choose_pivot(const int* P, int np, const int* PuX, int n, [[maybe_unused]] SearchStats& stats) const {
+        if (opts.pivot == PivotRule::First) return PuX[0];
+        if (opts.pivot == PivotRule::Middle) return PuX[n / 2];
+        int best = -1;
+        size_t best_count = 0;
+        for (int i = 0; i < n; ++i) {
+            const int u = PuX[i];
+            const size_t count = intersect_count(P, np, adj[u].data(), adj[u].size());
+            CLIQUE_STAT(stats.set_op(np, adj[u].size()));
+            if (best == -1 || count > best_count) {
+                best = u;
+                best_count = count;
+                if (count == (size_t)np) break;
+            }
+        }
+        return best;
+    }
+
+    // Enumerates the maximal cliques extending ws.R with candidates P and
+    // excluded vertices X. All per-node sets are carved out of ws.arena and
+    // handed back when the node's subtree is finished.
+    template <class Visitor>
+    void search_sets(const std::vector<int>& P, const std::vector<int>& X, Workspace& ws, int worker,
+                     Visitor& visit) {
+        Arena& arena = ws.arena;
+        std::vector<Frame>& frames = ws.frames;
+        constexpr bool list = !visits_size_only<Visitor>::value;
+        std::vector<int>& R = ws.R;
+        int& depth = ws.depth;
+
+        // Reports R if it is maximal, otherwise opens a frame that owns
+        // everything allocated since mark. Returns whether a frame was opened.
+        auto open = [&](Arena::Mark mark, int* Pn, int np, int* Xn, int nx) {
+            BK_SEARCH_NODE();
+            CLIQUE_STAT(ws.stats.node(depth));
+            ws.nodes++;
+            tick(ws, depth);
+            if (depth + np < opts.min_size) {
+                arena.release(mark);
+                return false;
+            }
+            if (np == 0) {
+                if (nx == 0) {
+                    visit(worker, list ? (const int*)R.data() : nullptr, depth);
+                    ws.cliques++;
+                }
+                CLIQUE_STAT(nx == 0 ? ws.stats.maximal++ : ws.stats.dead_ends++);
+                arena.release(mark);
+                return false;
+            }
+            int* cand = arena.alloc(np);
+            const Arena::Mark scratch = arena.mark();
+            int* PuX = arena.alloc(np + nx);
+            const int n = std::merge(Pn, Pn + np, Xn, Xn + nx, PuX) - PuX;
+            const int u = choose_pivot(Pn, np, PuX, n, ws.stats);
+            arena.release(scratch);
+            const int ncand = difference(Pn, np, adj[u].data(), adj[u].size(), cand);
+            CLIQUE_STAT(ws.stats.set_op(np, adj[u].size()); ws.stats.pivot_p += np; ws.stats.pivot_branches += ncand);
+            frames.push_back({Pn, Xn, cand, np, nx, ncand, 0, mark});
+            return true;
+        };
+
+        frames.clear();
+        const Arena::Mark root = arena.mark();
+        int* P0 = arena.alloc(P.size());
+        int* X0 = arena.alloc(X.size() + P.size());
+        std::copy(P.begin(), P.end(), P0);
+        std::copy(X.begin(), X.end(), X0);
+        open(root, P0, P.size(), X0, X.size());
+        if (!frames.empty()) top_level(ws, 0, frames[0].ncand);
+
+        while (!frames.empty()) {
+            Frame& f = frames.back();
+            if (frames.size() == 1) top_level(ws, f.next, f.ncand);
+            if (f.next == f.ncand || depth + f.np < opts.min_size) {
+                arena.release(f.mark);
+                frames.pop_back();
+                if (!frames.empty()) {
+                    if (list) R.pop_back();
+                    --depth;
+                }
+                continue;
+            }
+            const int v = f.cand[f.next++];
+            const auto& nv = adj[v];
+
+            const Arena::Mark mark = arena.mark();
+            int* Pn = arena.alloc(std::min<size_t>(f.np, nv.size()));
+            const int np = intersect(f.P, f.np, nv.data(), nv.size(), Pn);
+            int* Xn = arena.alloc(std::min<size_t>(f.nx, nv.size()) + np);
+            const int nx = intersect(f.X, f.nx, nv.data(), nv.size(), Xn);
+            CLIQUE_STAT(ws.stats.set_op(f.np, nv.size()); ws.stats.set_op(f.nx, nv.size()));
+
+            // Move v from P to X.
+            int* it_p = std::lower_bound(f.P, f.P + f.np, v);
+            if (it_p != f.P + f.np && *it_p == v) {
+                std::copy(it_p + 1, f.P + f.np, it_p);
+                --f.np;
+            }
+            int* it_x = std::upper_bound(f.X, f.X + f.nx, v);
+            std::copy_backward(it_x, f.X + f.nx, f.X + f.nx + 1);
+            *it_x = v;
+            ++f.nx;
+
+            if (list) R.push_back(v);
+            ++depth;
+            if (!open(mark, Pn, np, Xn, nx)) {
+                if (list) R.pop_back();
+                --depth;
+            }
+        }
+    }
+
+    // Bitset engine for searches whose P u X is small. The neighbourhood is
+    // remapped to dense positions 0..k-1, each local vertex gets a row of k
+    // bits holding its neighbours, and BK runs on word-parallel P/X/candidate
+    // sets, one frame per depth, with the pivot picked by popcount.
+    //
+    // Only the bits of P are ever read from a row of X (pivot counts), and
+    // only P vertices are branched on, so the rows come from walking P's
+    // neighbour lists alone, each edge setting both of its rows; edges
+    // inside X are never looked up.
+    template <class Visitor>
+    void search_bitset(const std::vector<int>& P, const std::vector<int>& X, Workspace& ws, int worker,
+                       Visitor& visit) {
+        std::vector<int>& local = ws.local;
+        local.resize(P.size() + X.size());
+        std::merge(P.begin(), P.end(), X.begin(), X.end(), local.begin());
+        const int k = local.size();
+        const int W = (k + 63) / 64;
+
+        std::vector<uint64_t>& rows = ws.rows;
+        rows.assign((size_t)k * W, 0);
+        for (int i = 0, ip = 0; ip < (int)P.size(); ++i) {
+            if (local[i] != P[ip]) continue;
+            ++ip;
+            auto link = [&](int j) {
+                rows[(size_t)i * W + (j >> 6)] |= 1ULL << (j & 63);
+                rows[(size_t)j * W + (i >> 6)] |= 1ULL << (i & 63);
+            };
+            const auto& nv = adj[local[i]];
+            if (nv.size() > 8 * (size_t)k) {
+                for (int j = 0; j < k; ++j) {
+                    if (std::binary_search(nv.begin(), nv.end(), local[j])) link(j);
+                }
+            } else {
+                const int* it = nv.begin();
+                for (int j = 0; j < k && it != nv.end();) {
+                    if (*it < local[j]) {
+                        ++it;
+                    } else {
+                        if (*it == local[j]) link(j);
+                        ++j;
+                    }
+                }
+            }
+        }
+
+        // Frame d holds P, X and the remaining candidates of the node whose
+        // clique is R plus d vertices (the search root is depth 0).
+        const int max_depth = P.size() + 1;
+        std::vector<uint64_t>& frames = ws.bits;
+        frames.resize((size_t)max_depth * 3 * W);
+        auto Pd = [&](int d) { return &frames[((size_t)d * 3) * W]; };
+        auto Xd = [&](int d) { return &frames[((size_t)d * 3 + 1) * W]; };
+        auto Cd = [&](int d) { return &frames[((size_t)d * 3 + 2) * W]; };
+
+        auto count = [&](const uint64_t* set) {
+            int c = 0;
+            for (int w = 0; w < W; ++w) c += __builtin_popcountll(set[w]);
+            return c;
+        };
+
+        // Candidates of frame d: P \ N(u) for the pivot u of P u X.
+        auto pivotCandidates = [&](int d) {
+            const uint64_t* p = Pd(d);
+            const uint64_t* x = Xd(d);
+            int best = -1, best_count = -1, p_count = 0;
+            for (int w = 0; w < W; ++w) p_count += __builtin_popcountll(p[w]);
+            if (opts.pivot != PivotRule::Tomita) {
+                // Position n/2 (Middle) or 0 (First) of the set bits in P u X.
+                int skip = 0;
+                if (opts.pivot == PivotRule::Middle) {
+                    for (int w = 0; w < W; ++w) skip += __builtin_popcountll(p[w] | x[w]);
+                    skip /= 2;
+                }
+                for (int w = 0; w < W && best == -1; ++w) {
+                    uint64_t bits = p[w] | x[w];
+                    const int c = __builtin_popcountll(bits);
+                    if (skip >= c) {
+                        skip -= c;
+                        continue;
+                    }
+                    while (skip--) bits &= bits - 1;
+                    best = (w << 6) | __builtin_ctzll(bits);
+                }
+                best_count = p_count;
+            }
+            for (int w = 0; w < W && best_count < p_count; ++w) {
+                uint64_t bits = p[w] | x[w];
+                while (bits) {
+                    const int u = (w << 6) | __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    const uint64_t* row = &rows[(size_t)u * W];
+                    int count = 0;
+                    for (int q = 0; q < W; ++q) count += __builtin_popcountll(p[q] & row[q]);
+                    CLIQUE_STAT(ws.stats.bitset_words += W);
+                    if (count > best_count) {
+                        best_count = count;
+                        best = u;
+                        if (count == p_count) break;
+                    }
+                }
+            }
+            const uint64_t* row = &rows[(size_t)best * W];
+            uint64_t* c = Cd(d);
+            for (int w = 0; w < W; ++w) c[w] = p[w] & ~row[w];
+            CLIQUE_STAT(ws.stats.bitset_words += W; ws.stats.pivot_p += p_count;
+                        for (int w = 0; w < W; ++w) ws.stats.pivot_branches += __builtin_popcountll(c[w]));
+        };
+
+        BK_SEARCH_NODE();
+        CLIQUE_STAT(ws.stats.node(ws.depth));
+        ws.nodes++;
+        if (P.empty()) {
+            CLIQUE_STAT(ws.stats.dead_ends++);
+            return;
+        }
+        std::fill(Pd(0), Pd(0) + 2 * W, 0);
+        for (int j = 0, ip = 0; j < k; ++j) {
+            if (ip < (int)P.size() && P[ip] == local[j]) {
+                Pd(0)[j >> 6] |= 1ULL << (j & 63);
+                ++ip;
+            } else {
+                Xd(0)[j >> 6] |= 1ULL << (j & 63);
+            }
+        }
+        pivotCandidates(0);
+        uint64_t root_branches = 0;
+        for (int w = 0; w < W; ++w) root_branches += __builtin_popcountll(Cd(0)[w]);
+
+        // scan[d] is the first candidate word of frame d that may still be non-zero.
+        constexpr bool list = !visits_size_only<Visitor>::value;
+        std::vector<int>& R = ws.R;
+        const int base = ws.depth;
+        std::vector<int>& scan = ws.scan;
+        scan.assign(max_depth, 0);
+        int d = 0;
+        while (d >= 0) {
+            uint64_t* c = Cd(d);
+            int word = scan[d];
+            while (word < W && c[word] == 0) ++word;
+            scan[d] = word;
+            if (d == 0 && ws.top_level_roots) {
+                uint64_t left = 0;
+                for (int w = word; w < W; ++w) left += __builtin_popcountll(c[w]);
+                top_level(ws, root_branches - left, root_branches);
+            }
+            if (word == W || (opts.min_size > 0 && base + d + count(Pd(d)) < opts.min_size)) {
+                --d;
+                continue;
+            }
+            const int v = (word << 6) | __builtin_ctzll(c[word]);
+            c[word] &= c[word] - 1;
+
+            const uint64_t* row = &rows[(size_t)v * W];
+            uint64_t* p = Pd(d);
+            uint64_t* x = Xd(d);
+            uint64_t* np = Pd(d + 1);
+            uint64_t* nx = Xd(d + 1);
+            uint64_t p_any = 0, x_any = 0;
+            for (int w = 0; w < W; ++w) {
+                np[w] = p[w] & row[w];
+                nx[w] = x[w] & row[w];
+                p_any |= np[w];
+                x_any |= nx[w];
+            }
+            p[v >> 6] &= ~(1ULL << (v & 63));
+            x[v >> 6] |= 1ULL << (v & 63);
+            if (list) {
+                R.resize(base + d);
+                R.push_back(local[v]);
+            }
+            const int size = base + d + 1;
+
+            BK_SEARCH_NODE();
+            CLIQUE_STAT(ws.stats.node(size); ws.stats.bitset_words += 2 * W);
+            ws.nodes++;
+            tick(ws, size);
+            if (opts.min_size > 0 && size + count(np) < opts.min_size) continue;
+            if (!p_any) {
+                if (!x_any) {
+                    visit(worker, list ? (const int*)R.data() : nullptr, size);
+                    ws.cliques++;
+                }
+                CLIQUE_STAT(!x_any ? ws.stats.maximal++ : ws.stats.dead_ends++);
+                continue;
+            }
+            ++d;
+            scan[d] = 0;
+            pivotCandidates(d);
+        }
+        if (list) R.resize(base);
+    }
+};
+
+// Visitor that builds the clique-size histogram, one count array per worker
+// merged on request.
+class CliqueHistogram {
+    std::vector<std::vector<long long>> counts;
+
+public:
+    static constexpr bool size_only = true;
+
+    explicit CliqueHistogram(int workers = 1) : counts(std::max(1, workers)) {}
+
+    void operator()(int worker, const int*, int size) {
+        std::vector<long long>& c = counts[worker];
+        if ((int)c.size() <= size) c.resize(size + 1, 0);
+        c[size]++;
+    }
+
+    // sizes()[s] is the number of maximal cliques with s vertices.
+    std::vector<long long> sizes() const {
+        std::vector<long long> total;
+        for (const auto& c : counts) {
+            if (total.size() < c.size()) total.resize(c.size(), 0);
+            for (size_t s = 0; s < c.size(); ++s) total[s] += c[s];
+        }
+        return total;
+    }
+};
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clique.h"
+#include "graph.h"
+#include "graph_io.h"
+
+// Out-of-core enumeration for graphs whose edges do not fit in memory.
+// Only per-vertex arrays (degrees, offsets, the order) are held in full;
+// everything that grows with the edges stays within a byte budget:
+//
+// build_snapshot_external turns an edge list into a snapshot (the format of
+// save_snapshot) in two streaming passes: one counts degrees, the other
+// spreads the edges into bucket files over vertex ranges small enough to be
+// sorted in memory. The buckets are then sorted one at a time into the
+// snapshot's neighbour section. The degeneracy order is computed on the
+// mapped result and stored with it.
+//
+// ShardedEnumerator then runs over such a mapped snapshot in shards: runs
+// of consecutive roots of the degeneracy order whose union of closed
+// neighbourhoods, copied out as an induced subgraph, fits the budget. A
+// root's whole search lives inside its closed neighbourhood, so each shard
+// is searched on its own small graph, and the mapped adjacency is only read
+// while a shard is cut out.
+
+namespace external_detail {
+
+// Calls fn(edges, max_node) for every line-aligned chunk of about chunk_bytes
+// of an edge list; max_node is the largest id seen so far, self-loops
+// included (as in load_edge_list).
+template <class Fn>
+bool for_each_edge_chunk(const std::string& filename, size_t chunk_bytes, Fn fn) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+    const char* p = file.data();
+    const char* limit = p + file.size();
+    std::vector<std::pair<int, int>> edges;
+    int max_node = -1;
+    while (p < limit) {
+        const char* end = p + std::min<size_t>(chunk_bytes, limit - p);
+        if (end < limit) {
+            const char* eol = static_cast<const char*>(memchr(end, '\n', limit - end));
+            end = eol ? eol + 1 : limit;
+        }
+        edges.clear();
+        edge_list_detail::parse_lines(p, end, limit, edges, max_node);
+        fn(edges, max_node);
+        p = end;
+    }
+    return true;
+}
+
+// Hands the cliques of a shard's local graph on in original vertex ids, and
+// finished roots at their positions in the full order (local position plus
+// root_offset).
+template <class Visitor>
+class ShardVisitor {
+    Visitor& visit;
+    const std::vector<int>& original;
+    std::vector<std::vector<int>> mapped;
+    int root_offset;
+
+public:
+    static constexpr bool size_only = visits_size_only<Visitor>::value;
+
+    ShardVisitor(Visitor& visit_, const std::vector<int>& original_ids, int workers, int root_offset_)
+        : visit(visit_), original(original_ids), mapped(workers), root_offset(root_offset_) {}
+
+    void root_done(int worker, int i) {
+        if constexpr (visits_root_done<Visitor>::value) visit.root_done(worker, i + root_offset);
+    }
+
+    void operator()(int worker, const int* clique, int size) {
+        if (size_only) {
+            visit(worker, nullptr, size);
+            return;
+        }
+        std::vector<int>& ids = mapped[worker];
+        ids.resize(size);
+        for (int j = 0; j < size; ++j) ids[j] = original[clique[j]];
+        visit(worker, ids.data(), size);
+    }
+};
+
+// Append-only file of (vertex, neighbour) pairs, written through a buffer.
+class PairFile {
+    std::string path_;
+    std::vector<int> buffer;
+    size_t capacity;
+    bool ok = true;
+
+public:
+    PairFile(std::string path, size_t buffer_pairs) : path_(std::move(path)), capacity(2 * buffer_pairs) {
+        std::ofstream(path_, std::ios::binary | std::ios::trunc);
+    }
+
+    const std::string& path() const { return path_; }
+
+    // The buffer is only allocated while pairs are pending, at exactly its
+    // capacity.
+    void add(int v, int w) {
+        if (buffer.empty()) buffer.reserve(capacity);
+        buffer.push_back(v);
+        buffer.push_back(w);
+        if (buffer.size() >= capacity) flush();
+    }
+
+    bool flush() {
+        if (!buffer.empty()) {
+            std::ofstream out(path_, std::ios::binary | std::ios::app);
+            out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(int));
+            ok &= bool(out);
+            std::vector<int>().swap(buffer);
+        }
+        return ok;
+    }
+};
+
+// Smallest budget build_snapshot_external takes, and the fewest pairs a
+// bucket's write buffer holds.
+constexpr size_t kMinBudget = 1 << 20;
+constexpr size_t kMinSpillPairs = 1024;
+
+}  // namespace external_detail
+
+// Streams an edge list into a snapshot with its degeneracy order, keeping
+// at most about budget_bytes of edge data in memory (a single vertex's
+// neighbour list always goes in one piece). Bucket files are written next
+// to the snapshot and removed again. Fails for a budget under 1 MiB.
+inline bool build_snapshot_external(const std::string& edge_list, const std::string& snapshot, size_t budget_bytes) {
+    using external_detail::PairFile;
+    if (budget_bytes < external_detail::kMinBudget) return false;
+    const size_t chunk_bytes = budget_bytes / 4;
+
+    // Pass 1: degrees, duplicates included, as an upper bound per vertex.
+    std::vector<uint64_t> degree;
+    int max_node = -1;
+    bool read = external_detail::for_each_edge_chunk(
+        edge_list, chunk_bytes, [&](const std::vector<std::pair<int, int>>& edges, int max_seen) {
+            max_node = max_seen;
+            if ((int)degree.size() <= max_node) degree.resize(max_node + 1, 0);
+            for (const auto& [a, b] : edges) {
+                if (a != b) {
+                    ++degree[a];
+                    ++degree[b];
+                }
+            }
+        });
+    if (!read) return false;
+    const int n = max_node + 1;
+    degree.resize(n, 0);
+
+    // Vertex ranges whose pairs (8 bytes each) fit the budget.
+    const uint64_t bucket_pairs = std::max<uint64_t>(1, budget_bytes / (2 * sizeof(int)));
+    std::vector<int> first_vertex;
+    uint64_t filled = bucket_pairs;
+    for (int v = 0; v < n; ++v) {
+        if (filled + degree[v] > bucket_pairs && filled > 0) {
+            first_vertex.push_back(v);
+            filled = 0;
+        }
+        filled += degree[v];
+    }
+    const int buckets = first_vertex.size();
+    first_vertex.push_back(n);
+    std::vector<int> bucket_of(n);
+    for (int b = 0; b < buckets; ++b) {
+        std::fill(bucket_of.begin() + first_vertex[b], bucket_of.begin() + first_vertex[b + 1], b);
+    }
+
+    // Pass 2: every edge into the buckets of both endpoints. The write
+    // buffers share a quarter of the budget; when that cannot give every
+    // bucket kMinSpillPairs, the buckets are filled a group at a time, with
+    // one read of the edge list per group.
+    const size_t spill_pairs = budget_bytes / 4 / (2 * sizeof(int));
+    const int group = std::max<size_t>(1, std::min<size_t>(buckets, spill_pairs / external_detail::kMinSpillPairs));
+    std::vector<PairFile> parts;
+    for (int b = 0; b < buckets; ++b) parts.emplace_back(snapshot + ".part" + std::to_string(b), spill_pairs / group);
+    bool ok = true;
+    for (int lo = 0; lo < buckets && ok; lo += group) {
+        const int hi = std::min(buckets, lo + group);
+        ok = external_detail::for_each_edge_chunk(
+            edge_list, chunk_bytes, [&](const std::vector<std::pair<int, int>>& edges, int) {
+                for (const auto& [a, b] : edges) {
+                    if (a == b) continue;
+                    if (bucket_of[a] >= lo && bucket_of[a] < hi) parts[bucket_of[a]].add(a, b);
+                    if (bucket_of[b] >= lo && bucket_of[b] < hi) parts[bucket_of[b]].add(b, a);
+                }
+            });
+        for (int b = lo; b < hi; ++b) ok &= parts[b].flush();
+    }
+    std::vector<int>().swap(bucket_of);
+
+    // Sort the buckets in vertex order into the neighbour section; the
+    // offsets are known once all of them are done.
+    std::vector<uint64_t> offsets(n + 1, 0);
+    std::fstream out;
+    if (ok) out.open(snapshot, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    SnapshotHeader header = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<int> neighbours;
+    for (int b = 0; b < buckets && out; ++b) {
+        std::ifstream in(parts[b].path(), std::ios::binary | std::ios::ate);
+        pairs.resize(in.tellg() / sizeof(pairs[0]));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(pairs.data()), pairs.size() * sizeof(pairs[0]));
+        in.close();
+        std::remove(parts[b].path().c_str());
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        neighbours.resize(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            ++offsets[pairs[i].first + 1];
+            neighbours[i] = pairs[i].second;
+        }
+        out.write(reinterpret_cast<const char*>(neighbours.data()), neighbours.size() * sizeof(int));
+    }
+    for (const PairFile& part : parts) std::remove(part.path().c_str());
+    if (!out) return false;
+    std::vector<std::pair<int, int>>().swap(pairs);
+    std::vector<int>().swap(neighbours);
+    for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+    const uint64_t entries = offsets[n];
+    const std::streamoff body = sizeof header;
+    out.seekp(body);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    // Checksum over the offsets and, read back in blocks, the neighbours.
+    uint64_t checksum = snapshot_checksum(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    std::vector<uint64_t>().swap(offsets);
+    {
+        std::vector<char> block(1 << 20);
+        out.seekg(body + (std::streamoff)(n + 1) * sizeof(uint64_t));
+        for (uint64_t left = entries * sizeof(int); left > 0 && out;) {
+            const size_t size = std::min<uint64_t>(block.size(), left);
+            out.read(block.data(), size);
+            checksum = snapshot_checksum(block.data(), size, checksum);
+            left -= size;
+        }
+    }
+    memcpy(header.magic, kSnapshotMagic, sizeof header.magic);
+    header.version = kSnapshotVersion;
+    header.n = n;
+    header.m = entries;
+    header.checksum = checksum;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof header);
+    out.close();
+    if (!out) return false;
+
+    // The degeneracy order, peeled on the mapped graph and appended.
+    std::vector<int> order;
+    {
+        CSRGraph graph;
+        int mapped_n;
+        if (!load_snapshot(snapshot, mapped_n, graph, order)) return false;
+        order = core_decomposition(graph);
+    }
+    header.flags |= kSnapshotHasOrder;
+    header.checksum = snapshot_checksum(reinterpret_cast<const char*>(order.data()), n * sizeof(int32_t), checksum);
+    std::fstream patch(snapshot, std::ios::in | std::ios::out | std::ios::binary);
+    patch.seekp(0, std::ios::end);
+    patch.write(reinterpret_cast<const char*>(order.data()), n * sizeof(int32_t));
+    patch.seekp(0);
+    patch.write(reinterpret_cast<const char*>(&header), sizeof header);
+    return bool(patch);
+}
+
+// Maximal-clique enumeration shard by shard (see the top of this file). The
+// visitor sees original vertex ids and worker indices in [0, threads), as
+// with CliqueEnumerator::run.
+class ShardedEnumerator {
+    const CSRGraph& adj;
+    CliqueOptions opts;
+    std::vector<int> order_;
+    std::vector<int> pos;
+    size_t budget;
+    int shards_ = 0;
+    size_t largest_shard = 0;
+
+    // Bytes to copy out vertex w: its share of the induced edge pairs and
+    // its neighbour list, both bounded by its degree.
+    size_t cost(int w) const { return adj.degree(w) * 2 * sizeof(int) + sizeof(uint64_t); }
+
+public:
+    // order must be a degeneracy order of graph (e.g. from its snapshot).
+    ShardedEnumerator(const CSRGraph& graph, std::vector<int> order, CliqueOptions options, size_t budget_bytes)
+        : adj(graph), opts(options), order_(std::move(order)), pos(graph.size()), budget(budget_bytes) {
+        opts.threads = std::max(1, opts.threads);
+        for (int i = 0; i < (int)order_.size(); ++i) pos[order_[i]] = i;
+    }
+
+    int shards() const { return shards_; }
+    // Estimated bytes of the biggest shard; above the budget only when a
+    // single root's neighbourhood is.
+    size_t largest_shard_bytes() const { return largest_shard; }
+
+    template <class Visitor>
+    void run(Visitor& visit) { run(visit, 0, adj.size()); }
+
+    // The roots at positions [first, last) of the order only, as with
+    // CliqueEnumerator::run(visit, first, last).
+    template <class Visitor>
+    void run(Visitor& visit, int first, int last) {
+        std::vector<int> local_of(adj.size(), -1);
+        std::vector<int> members;
+        for (int lo = first; lo < last;) {
+            // Grow the shard root by root while its vertices fit.
+            members.clear();
+            size_t bytes = 0;
+            int hi = lo;
+            while (hi < last) {
+                const int v = order_[hi];
+                size_t extra = local_of[v] < 0 ? cost(v) : 0;
+                for (int w : adj[v]) extra += local_of[w] < 0 ? cost(w) : 0;
+                if (hi > lo && bytes + extra > budget) break;
+                bytes += extra;
+                if (local_of[v] < 0) {
+                    local_of[v] = 0;
+                    members.push_back(v);
+                }
+                for (int w : adj[v]) {
+                    if (local_of[w] < 0) {
+                        local_of[w] = 0;
+                        members.push_back(w);
+                    }
+                }
+                ++hi;
+            }
+            run_shard(lo, hi, members, local_of, visit);
+            for (int w : members) local_of[w] = -1;
+            largest_shard = std::max(largest_shard, bytes);
+            ++shards_;
+            lo = hi;
+        }
+    }
+
+private:
+    // Copies out the subgraph induced by members, numbered by their
+    // position in the order so that the local order is the identity, and
+    // searches the roots at positions [lo, hi) on it. Those are exactly the
+    // members between the ones that come earlier and later in the order.
+    template <class Visitor>
+    void run_shard(int lo, int hi, std::vector<int>& members, std::vector<int>& local_of, Visitor& visit) {
+        std::sort(members.begin(), members.end(), [&](int a, int b) { return pos[a] < pos[b]; });
+        const int k = members.size();
+        for (int i = 0; i < k; ++i) local_of[members[i]] = i;
+        std::vector<std::vector<std::pair<int, int>>> edges(1);
+        for (int i = 0; i < k; ++i) {
+            for (int w : adj[members[i]]) {
+                if (local_of[w] > i) edges[0].emplace_back(i, local_of[w]);
+            }
+        }
+        CSRGraph local;
+        build_csr(k, edges, local);
+        std::vector<int> identity(k);
+        for (int i = 0; i < k; ++i) identity[i] = i;
+        const int first = std::partition_point(members.begin(), members.end(), [&](int w) { return pos[w] < lo; }) -
+                          members.begin();
+
+        CliqueEnumerator enumerator(local, opts);
+        enumerator.set_order(std::move(identity));
+        external_detail::ShardVisitor<Visitor> forward(visit, members, opts.threads, lo - first);
+        enumerator.run(forward, first, first + (hi - lo));
+    }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+static_assert(sizeof(int) == 4, "CSR neighbour arrays are stored as 32-bit ints");
+
+// Read-only view of one vertex's neighbours: a contiguous, sorted run of ids.
+class NeighborSpan {
+    const int* first;
+    const int* last;
+
+public:
+    NeighborSpan(const int* first_, const int* last_) : first(first_), last(last_) {}
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    const int* data() const { return first; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
+// Undirected graph in compressed sparse row form: the neighbours of v are
+// neighbours[offsets[v] .. offsets[v + 1]), sorted and free of duplicates.
+// The arrays are either owned or borrowed from a mapping (e.g. a snapshot
+// file) that the graph keeps alive.
+class CSRGraph {
+    std::vector<uint64_t> owned_offsets;
+    std::vector<int> owned_neighbours;
+    std::shared_ptr<const void> backing;
+    const uint64_t* offsets = nullptr;
+    const int* neighbours = nullptr;
+    int n = 0;
+
+public:
+    CSRGraph() = default;
+    CSRGraph(const CSRGraph&) = delete;
+    CSRGraph& operator=(const CSRGraph&) = delete;
+    CSRGraph(CSRGraph&&) = default;
+    CSRGraph& operator=(CSRGraph&&) = default;
+
+    // Takes ownership of offsets (n + 1 entries) and the neighbour array.
+    void assign(std::vector<uint64_t> offsets_, std::vector<int> neighbours_) {
+        backing.reset();
+        owned_offsets = std::move(offsets_);
+        owned_neighbours = std::move(neighbours_);
+        n = owned_offsets.empty() ? 0 : owned_offsets.size() - 1;
+        offsets = owned_offsets.empty() ? nullptr : owned_offsets.data();
+        neighbours = owned_neighbours.data();
+    }
+
+    // Borrows arrays that live inside `owner`, which is kept alive as long
+    // as the graph is.
+    void attach(std::shared_ptr<const void> owner, int n_, const uint64_t* offsets_, const int* neighbours_) {
+        owned_offsets.clear();
+        owned_neighbours.clear();
+        backing = std::move(owner);
+        n = n_;
+        offsets = offsets_;
+        neighbours = neighbours_;
+    }
+
+    int size() const { return n; }
+    // Number of neighbour entries, i.e. twice the number of edges.
+    uint64_t entries() const { return n ? offsets[n] : 0; }
+    uint64_t edges() const { return entries() / 2; }
+
+    size_t degree(int v) const { return offsets[v + 1] - offsets[v]; }
+    NeighborSpan operator[](int v) const {
+        return NeighborSpan(neighbours + offsets[v], neighbours + offsets[v + 1]);
+    }
+
+    const uint64_t* offset_data() const { return offsets; }
+    const int* neighbour_data() const { return neighbours; }
+};
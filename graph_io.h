@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only view of a whole file. Uses mmap where available and falls back
+// to reading the file into memory elsewhere.
+class MappedFile {
+    const char* ptr = nullptr;
+    size_t len = 0;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        ptr = buffer.data();
+        len = buffer.size();
+        return true;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        len = st.st_size;
+        if (len > 0) {
+            void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                len = 0;
+                return false;
+            }
+            madvise(p, len, MADV_SEQUENTIAL);
+            ptr = static_cast<const char*>(p);
+        }
+        ::close(fd);
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        buffer.clear();
+#else
+        if (ptr) munmap(const_cast<char*>(ptr), len);
+#endif
+        ptr = nullptr;
+        len = 0;
+    }
+
+    const char* data() const { return ptr; }
+    size_t size() const { return len; }
+};
+
+namespace edge_list_detail {
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Parses a non-negative int at p, the way `istream >> int` would after
+// skipping blanks. Returns false on no digits, a minus sign or overflow.
+inline bool parse_int(const char*& p, const char* end, int& out) {
+    while (p < end && is_blank(*p)) ++p;
+    if (p < end && *p == '+') ++p;
+    if (p == end || *p < '0' || *p > '9') return false;
+    long long value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p - '0');
+        if (value > INT_MAX) return false;
+        ++p;
+    }
+    out = static_cast<int>(value);
+    return true;
+}
+
+// Parses every line that starts in [begin, end) of the buffer ending at limit.
+inline void parse_lines(const char* begin, const char* end, const char* limit,
+                        std::vector<std::pair<int, int>>& edges, int& max_node) {
+    const char* p = begin;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', limit - p));
+        if (!eol) eol = limit;
+        if (p != eol && *p != '#') {
+            const char* q = p;
+            int a, b;
+            if (parse_int(q, eol, a) && parse_int(q, eol, b)) {
+                max_node = std::max(max_node, std::max(a, b));
+                edges.emplace_back(a, b);
+            }
+        }
+        if (eol == limit) break;
+        p = eol + 1;
+    }
+}
+
+}  // namespace edge_list_detail
+
+// Builds the CSR adjacency of an undirected graph on vertices [0, n) from
+// edge lists (e.g. one per parsing thread), which are freed on the way.
+// Self-loops are dropped and parallel edges merged; sorting the neighbour
+// lists is split over `threads` workers.
+inline void build_csr(int n, std::vector<std::vector<std::pair<int, int>>>& edges, CSRGraph& graph,
+                      int threads = 1) {
+    threads = std::max(1, threads);
+    std::vector<std::thread> workers;
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (const auto& part : edges) {
+        for (const auto& [a, b] : part) {
+            if (a != b) {
+                ++offsets[a + 1];
+                ++offsets[b + 1];
+            }
+        }
+    }
+    for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+    std::vector<int> neighbours(offsets[n]);
+    std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+    for (auto& part : edges) {
+        for (const auto& [a, b] : part) {
+            if (a != b) {
+                neighbours[fill[a]++] = b;
+                neighbours[fill[b]++] = a;
+            }
+        }
+        std::vector<std::pair<int, int>>().swap(part);
+    }
+
+    // Sort and deduplicate every list in place; fill[v] becomes its new end.
+    auto finish = [&](int lo, int hi) {
+        for (int v = lo; v < hi; ++v) {
+            int* first = neighbours.data() + offsets[v];
+            int* last = neighbours.data() + offsets[v + 1];
+            std::sort(first, last);
+            fill[v] = std::unique(first, last) - neighbours.data();
+        }
+    };
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(finish, (long long)n * t / threads, (long long)n * (t + 1) / threads);
+    }
+    finish(0, (long long)n / threads);
+    for (auto& w : workers) w.join();
+
+    // Close the gaps left by duplicates; lists only ever move down.
+    uint64_t out = 0;
+    for (int v = 0; v < n; ++v) {
+        const uint64_t first = offsets[v];
+        const uint64_t last = fill[v];
+        offsets[v] = out;
+        if (out != first) std::copy(neighbours.begin() + first, neighbours.begin() + last, neighbours.begin() + out);
+        out += last - first;
+    }
+    offsets[n] = out;
+    neighbours.resize(out);
+    neighbours.shrink_to_fit();
+    graph.assign(std::move(offsets), std::move(neighbours));
+}
+
+// Loads a whitespace-separated edge list ("a b" per line). Blank lines, lines
+// starting with '#' and lines without two leading integers are skipped. The
+// file is mapped once and cut into line-aligned chunks parsed by `threads`
+// workers (0 = all cores). Self-loops still count towards n but add no edge;
+// every neighbour list comes back sorted and free of duplicates.
+inline bool load_edge_list(const std::string& filename, int& n, CSRGraph& graph, int threads = 0) {
+    MappedFile file;
+    if (!file.open(filename)) return false;
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    const char* data = file.data();
+    const char* limit = data + file.size();
+    const size_t chunk_target = size_t(1) << 20;
+    threads = std::max(1, std::min<int>(threads, file.size() / chunk_target + 1));
+
+    // Chunk t owns the lines that start in [cut[t], cut[t + 1]).
+    std::vector<const char*> cut(threads + 1, limit);
+    cut[0] = data;
+    for (int t = 1; t < threads; ++t) {
+        const char* p = data + file.size() * t / threads;
+        p = std::max(p, cut[t - 1]);
+        const char* eol = p < limit ? static_cast<const char*>(memchr(p, '\n', limit - p)) : nullptr;
+        cut[t] = eol ? eol + 1 : limit;
+    }
+
+    std::vector<std::vector<std::pair<int, int>>> edges(threads);
+    std::vector<int> max_node(threads, -1);
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            edge_list_detail::parse_lines(cut[t], cut[t + 1], limit, edges[t], max_node[t]);
+        });
+    }
+    edge_list_detail::parse_lines(cut[0], cut[1], limit, edges[0], max_node[0]);
+    for (auto& w : workers) w.join();
+    workers.clear();
+    file.close();
+
+    n = *std::max_element(max_node.begin(), max_node.end()) + 1;
+    build_csr(n, edges, graph, threads);
+    return true;
+}
+
+// Binary CSR snapshot of a loaded graph, so repeated runs can skip parsing.
+// Layout (host byte order, every section naturally aligned):
+//   SnapshotHeader
+//   uint64_t offsets[n + 1]    neighbours of v are [offsets[v], offsets[v + 1])
+//   int32_t  neighbours[m]     sorted and deduplicated per vertex
+//   int32_t  order[n]          degeneracy order, present if kSnapshotHasOrder
+// The checksum chains snapshot_checksum over the three sections in order.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t n;
+    uint64_t m;
+    uint64_t checksum;
+};
+static_assert(sizeof(SnapshotHeader) == 40, "snapshot header must not be padded");
+
+constexpr char kSnapshotMagic[8] = {'B', 'K', 'C', 'S', 'R', '\0', '\0', '\0'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotHasOrder = 1;
+
+// FNV-1a over 64-bit words (the tail is zero-padded). load_snapshot only
+// checks it when asked to verify (q2's --verify-binary).
+inline uint64_t snapshot_checksum(const char* data, size_t size, uint64_t h = 0xcbf29ce484222325ULL) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0x100000001b3ULL;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        memcpy(&word, data + i, size - i);
+        h = (h ^ word) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+inline bool save_snapshot(const std::string& filename, const CSRGraph& graph, const std::vector<int>* order) {
+    const size_t n = graph.size();
+    const uint64_t no_offsets = 0;
+    const char* offsets = reinterpret_cast<const char*>(n ? graph.offset_data() : &no_offsets);
+    const char* neighbours = reinterpret_cast<const char*>(graph.neighbour_data());
+    const size_t offset_bytes = (n + 1) * sizeof(uint64_t);
+    const size_t neighbour_bytes = graph.entries() * sizeof(int32_t);
+
+    SnapshotHeader header;
+    memcpy(header.magic, kSnapshotMagic, sizeof header.magic);
+    header.version = kSnapshotVersion;
+    header.flags = order ? kSnapshotHasOrder : 0;
+    header.n = n;
+    header.m = graph.entries();
+    header.checksum = snapshot_checksum(offsets, offset_bytes);
+    header.checksum = snapshot_checksum(neighbours, neighbour_bytes, header.checksum);
+    if (order) {
+        header.checksum = snapshot_checksum(reinterpret_cast<const char*>(order->data()),
+                                            n * sizeof(int32_t), header.checksum);
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof header);
+    file.write(offsets, offset_bytes);
+    file.write(neighbours, neighbour_bytes);
+    if (order) file.write(reinterpret_cast<const char*>(order->data()), n * sizeof(int32_t));
+    return bool(file);
+}
+
+// Maps a snapshot written by save_snapshot and points the graph straight at
+// the mapped arrays; nothing is parsed or copied. The header, section sizes,
+// offsets and order are always checked. The checksum pass reads every edge,
+// so it only runs when verify is set. order is left empty when the snapshot
+// carries none.
+inline bool load_snapshot(const std::string& filename, int& n, CSRGraph& graph,
+                          std::vector<int>& order, bool verify = false) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(filename) || file->size() < sizeof(SnapshotHeader)) return false;
+    SnapshotHeader header;
+    memcpy(&header, file->data(), sizeof header);
+    if (memcmp(header.magic, kSnapshotMagic, sizeof header.magic) != 0) return false;
+    if (header.version != kSnapshotVersion || header.n > (uint64_t)INT_MAX) return false;
+
+    const bool has_order = header.flags & kSnapshotHasOrder;
+    const size_t offset_bytes = (header.n + 1) * sizeof(uint64_t);
+    const size_t neighbour_bytes = header.m * sizeof(int32_t);
+    const size_t order_bytes = has_order ? header.n * sizeof(int32_t) : 0;
+    if (file->size() != sizeof header + offset_bytes + neighbour_bytes + order_bytes) return false;
+    const char* body = file->data() + sizeof header;
+    if (verify) {
+        uint64_t checksum = snapshot_checksum(body, offset_bytes);
+        checksum = snapshot_checksum(body + offset_bytes, neighbour_bytes, checksum);
+        if (has_order) checksum = snapshot_checksum(body + offset_bytes + neighbour_bytes, order_bytes, checksum);
+        if (checksum != header.checksum) return false;
+    }
+
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(body);
+    const int* neighbours = reinterpret_cast<const int*>(body + offset_bytes);
+    if (offsets[0] != 0 || offsets[header.n] != header.m) return false;
+    for (uint64_t v = 0; v < header.n; ++v) {
+        if (offsets[v] > offsets[v + 1]) return false;
+    }
+
+    n = header.n;
+    order.clear();
+    if (has_order) {
+        const int* stored = neighbours + header.m;
+        std::vector<bool> seen(n, false);
+        for (int i = 0; i < n; ++i) {
+            if (stored[i] < 0 || stored[i] >= n || seen[stored[i]]) return false;
+            seen[stored[i]] = true;
+        }
+        order.assign(stored, stored + n);
+    }
+    graph.attach(file, n, offsets, neighbours);
+    return true;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "clique.h"
+#include "graph.h"
+#include "graph_io.h"
+
+// Keeps the maximal-clique histogram of a graph current under batches of
+// edge insertions and deletions. A maximal clique can only appear or vanish
+// if it holds a touched vertex (an endpoint of an edge that changed): for
+// any other clique neither its own edges nor the edges to a vertex that
+// could extend it are different. So the histogram moves by the cliques
+// through touched vertices in the new graph minus those in the old one, and
+// both sets live in the subgraph induced by the touched vertices' closed
+// neighbourhoods. clique_size_delta only ever builds and searches that
+// subgraph, so its cost follows the neighbourhood of the change, not the
+// size of the graph.
+
+struct EdgeChange {
+    int u, v;
+    bool insert;
+};
+
+// Reads a batch of changes, one "+ u v" (insert) or "- u v" (delete) per
+// line; blank lines and lines starting with '#' are skipped. Fails on a
+// line that is neither.
+inline bool load_edge_changes(const std::string& filename, std::vector<EdgeChange>& changes) {
+    std::ifstream in(filename);
+    if (!in) return false;
+    changes.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        std::istringstream fields(line);
+        std::string op;
+        long long u, v;
+        if (!(fields >> op >> u >> v) || (op != "+" && op != "-") || u < 0 || v < 0 || u > INT_MAX || v > INT_MAX) {
+            return false;
+        }
+        changes.push_back({(int)u, (int)v, op == "+"});
+    }
+    return true;
+}
+
+namespace incremental_detail {
+
+inline bool has_edge(const CSRGraph& graph, int u, int v) {
+    if (u >= graph.size()) return false;
+    const auto& nu = graph[u];
+    return std::binary_search(nu.begin(), nu.end(), v);
+}
+
+inline uint64_t edge_key(int u, int v) { return (uint64_t)std::min(u, v) << 32 | (uint32_t)std::max(u, v); }
+
+// Histogram of the maximal cliques of `local` that contain a vertex of
+// `touched` (sorted local ids): the cliques through touched[i] that avoid
+// touched[0..i) are those of R = {touched[i]}, P = its other neighbours and
+// X = its neighbours among touched[0..i).
+inline std::vector<long long> cliques_through(const CSRGraph& local, const std::vector<int>& touched,
+                                              const CliqueOptions& options) {
+    CliqueEnumerator enumerator(local, options);
+    CliqueHistogram histogram;
+    std::vector<char> done(local.size(), 0);
+    std::vector<int> P, X;
+    for (int t : touched) {
+        P.clear();
+        X.clear();
+        for (int w : local[t]) (done[w] ? X : P).push_back(w);
+        enumerator.expand({t}, P, X, histogram);
+        done[t] = 1;
+    }
+    return histogram.sizes();
+}
+
+}  // namespace incremental_detail
+
+// The edges a batch really changes, each once as u < v: the last operation
+// on an edge wins, and self-loops, inserts of present edges and deletes of
+// absent ones are dropped.
+inline std::vector<EdgeChange> net_edge_changes(const CSRGraph& graph, const std::vector<EdgeChange>& batch) {
+    std::unordered_map<uint64_t, bool> last;
+    for (const EdgeChange& c : batch) {
+        if (c.u != c.v) last[incremental_detail::edge_key(c.u, c.v)] = c.insert;
+    }
+    std::vector<EdgeChange> net;
+    for (const auto& [key, insert] : last) {
+        const int u = key >> 32, v = (uint32_t)key;
+        if (insert != incremental_detail::has_edge(graph, u, v)) net.push_back({u, v, insert});
+    }
+    std::sort(net.begin(), net.end(), [](const EdgeChange& a, const EdgeChange& b) {
+        return a.u != b.u ? a.u < b.u : a.v < b.v;
+    });
+    return net;
+}
+
+// How the clique-size histogram of graph changes under net changes (see
+// net_edge_changes): delta[s] is the number of maximal cliques of size s
+// after, minus before. Vertices may be new, i.e. at or past graph.size().
+inline std::vector<long long> clique_size_delta(const CSRGraph& graph, const std::vector<EdgeChange>& changes,
+                                                const CliqueOptions& options = {}) {
+    std::vector<int> touched;
+    for (const EdgeChange& c : changes) {
+        touched.push_back(c.u);
+        touched.push_back(c.v);
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    // Local ids over the touched vertices and their old neighbours (the new
+    // ones are old neighbours or touched themselves), in increasing order.
+    std::vector<int> around = touched;
+    for (int t : touched) {
+        if (t < graph.size()) around.insert(around.end(), graph[t].begin(), graph[t].end());
+    }
+    std::sort(around.begin(), around.end());
+    around.erase(std::unique(around.begin(), around.end()), around.end());
+    std::unordered_map<int, int> local_id;
+    local_id.reserve(around.size() * 2);
+    for (int i = 0; i < (int)around.size(); ++i) local_id[around[i]] = i;
+
+    // Induced edges before and after.
+    std::unordered_set<uint64_t> deleted;
+    std::vector<std::vector<std::pair<int, int>>> before(1), after(1);
+    for (const EdgeChange& c : changes) {
+        if (c.insert) after[0].emplace_back(local_id[c.u], local_id[c.v]);
+        else deleted.insert(incremental_detail::edge_key(c.u, c.v));
+    }
+    for (int i = 0; i < (int)around.size(); ++i) {
+        const int s = around[i];
+        if (s >= graph.size()) continue;
+        for (int w : graph[s]) {
+            if (w <= s) continue;
+            const auto it = local_id.find(w);
+            if (it == local_id.end()) continue;
+            before[0].emplace_back(i, it->second);
+            if (!deleted.count(incremental_detail::edge_key(s, w))) after[0].emplace_back(i, it->second);
+        }
+    }
+    std::vector<int> local_touched(touched.size());
+    for (size_t i = 0; i < touched.size(); ++i) local_touched[i] = local_id[touched[i]];
+
+    CSRGraph old_local, new_local;
+    build_csr(around.size(), before, old_local);
+    build_csr(around.size(), after, new_local);
+    std::vector<long long> delta = incremental_detail::cliques_through(new_local, local_touched, options);
+    const std::vector<long long> removed = incremental_detail::cliques_through(old_local, local_touched, options);
+    if (delta.size() < removed.size()) delta.resize(removed.size(), 0);
+    for (size_t s = 0; s < removed.size(); ++s) delta[s] -= removed[s];
+    return delta;
+}
+
+// Writes graph with net changes applied to out; the vertex count grows to
+// cover new ids. Untouched neighbour lists are copied as they are.
+inline void apply_edge_changes(const CSRGraph& graph, const std::vector<EdgeChange>& changes, CSRGraph& out) {
+    int n = graph.size();
+    std::unordered_map<int, std::vector<int>> added, removed;
+    for (const EdgeChange& c : changes) {
+        n = std::max(n, std::max(c.u, c.v) + 1);
+        auto& side = c.insert ? added : removed;
+        side[c.u].push_back(c.v);
+        side[c.v].push_back(c.u);
+    }
+    for (auto& entry : added) std::sort(entry.second.begin(), entry.second.end());
+    for (auto& entry : removed) std::sort(entry.second.begin(), entry.second.end());
+
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        int64_t degree = v < graph.size() ? graph.degree(v) : 0;
+        if (added.count(v)) degree += added[v].size();
+        if (removed.count(v)) degree -= removed[v].size();
+        offsets[v + 1] = offsets[v] + degree;
+    }
+    std::vector<int> neighbours(offsets[n]);
+    static const std::vector<int> none;
+    for (int v = 0; v < n; ++v) {
+        int* dest = neighbours.data() + offsets[v];
+        const int* first = v < graph.size() ? graph[v].begin() : nullptr;
+        const int* last = v < graph.size() ? graph[v].end() : nullptr;
+        const auto a = added.find(v);
+        const auto r = removed.find(v);
+        if (a == added.end() && r == removed.end()) {
+            std::copy(first, last, dest);
+            continue;
+        }
+        const std::vector<int>& add = a == added.end() ? none : a->second;
+        const std::vector<int>& drop = r == removed.end() ? none : r->second;
+        std::vector<int> kept;
+        std::set_difference(first, last, drop.begin(), drop.end(), std::back_inserter(kept));
+        std::merge(kept.begin(), kept.end(), add.begin(), add.end(), dest);
+    }
+    out.assign(std::move(offsets), std::move(neighbours));
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "clique.h"
+#include "graph.h"
+
+// Exact maximum clique by branch and bound, without enumerating maximal
+// cliques. Every vertex v is a root for the cliques whose earliest vertex in
+// the degeneracy order is v, so its candidates are its later neighbours and
+// the clique is at most core(v) + 1 big; roots and candidates whose core
+// number cannot beat the incumbent are dropped before any search. Inside a
+// root the search runs on bitsets over the candidates (BBMC): a greedy
+// colouring of P bounds the clique each vertex can still complete, and
+// vertices whose colour cannot lift |C| past the incumbent are never
+// branched on. Workers share the incumbent, so a large clique found by one
+// prunes the others right away.
+
+namespace max_clique_detail {
+
+// Best clique found so far, shared by all workers.
+class Incumbent {
+    std::atomic<int> best{0};
+    std::mutex m;
+    std::vector<int> members;
+
+public:
+    int size() const { return best.load(std::memory_order_relaxed); }
+
+    void offer(const std::vector<int>& clique) {
+        if ((int)clique.size() <= size()) return;
+        std::lock_guard<std::mutex> lock(m);
+        if (clique.size() > members.size()) {
+            members = clique;
+            best.store(clique.size(), std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<int> clique() {
+        std::lock_guard<std::mutex> lock(m);
+        return members;
+    }
+};
+
+// One worker's search state, reused from root to root.
+class Search {
+    const CSRGraph& adj;
+    Incumbent& incumbent;
+    std::vector<int> local_of;  // vertex -> local index in the current root, or -1
+    std::vector<int> local;     // local index -> vertex
+    std::vector<uint64_t> rows;
+    int W = 0;
+    // Per depth: the live P and the colouring's scratch sets.
+    std::vector<std::vector<uint64_t>> P, U, Q;
+    std::vector<std::vector<int>> branch, colour;
+    std::vector<int> C;
+
+    void ensure_depth(int d) {
+        if ((int)P.size() > d) return;
+        P.resize(d + 1);
+        U.resize(d + 1);
+        Q.resize(d + 1);
+        branch.resize(d + 1);
+        colour.resize(d + 1);
+    }
+
+    void expand(int d) {
+        P[d + 1].resize(W);
+        U[d + 1].resize(W);
+        Q[d + 1].resize(W);
+        uint64_t* p = P[d].data();
+        uint64_t* u = U[d].data();
+        uint64_t* q = Q[d].data();
+        std::vector<int>& vs = branch[d];
+        std::vector<int>& cs = colour[d];
+        vs.clear();
+        cs.clear();
+
+        // Greedy colouring: colour classes are independent sets taken in
+        // local order. A vertex of colour c can complete C to at most
+        // |C| + c, so only colours >= kmin are worth branching on.
+        const int kmin = incumbent.size() - (int)C.size() + 1;
+        std::copy(p, p + W, u);
+        int colour_count = 0;
+        for (bool any = true; any;) {
+            any = false;
+            for (int w = 0; w < W; ++w) any |= u[w] != 0;
+            if (!any) break;
+            ++colour_count;
+            std::copy(u, u + W, q);
+            for (int w = 0; w < W; ++w) {
+                while (q[w]) {
+                    const int v = (w << 6) | __builtin_ctzll(q[w]);
+                    q[w] &= q[w] - 1;
+                    u[w] &= ~(1ULL << (v & 63));
+                    const uint64_t* row = &rows[(size_t)v * W];
+                    for (int x = w; x < W; ++x) q[x] &= ~row[x];
+                    if (colour_count >= kmin) {
+                        vs.push_back(v);
+                        cs.push_back(colour_count);
+                    }
+                }
+            }
+        }
+
+        for (int i = vs.size() - 1; i >= 0; --i) {
+            if ((int)C.size() + cs[i] <= incumbent.size()) return;
+            const int v = vs[i];
+            const uint64_t* row = &rows[(size_t)v * W];
+            uint64_t* np = P[d + 1].data();
+            bool any = false;
+            for (int w = 0; w < W; ++w) {
+                np[w] = p[w] & row[w];
+                any |= np[w] != 0;
+            }
+            C.push_back(local[v]);
+            if (any) expand(d + 1);
+            else incumbent.offer(C);
+            C.pop_back();
+            p[v >> 6] &= ~(1ULL << (v & 63));
+        }
+    }
+
+public:
+    Search(const CSRGraph& graph, Incumbent& best) : adj(graph), incumbent(best), local_of(graph.size(), -1) {}
+
+    // Searches the cliques made of v and vertices of cand (v's neighbours).
+    void root(int v, const std::vector<int>& cand) {
+        if ((int)cand.size() + 1 <= incumbent.size()) return;
+        if (cand.empty()) {
+            incumbent.offer({v});
+            return;
+        }
+        // Local order: decreasing degree inside the candidate set, so the
+        // colouring packs the dense part into few colours.
+        const int k = cand.size();
+        W = (k + 63) / 64;
+        std::vector<int> degree(k, 0);
+        for (int i = 0; i < k; ++i) local_of[cand[i]] = i;
+        for (int i = 0; i < k; ++i) {
+            for (int w : adj[cand[i]]) degree[i] += local_of[w] >= 0;
+        }
+        std::vector<int> by_degree(k);
+        for (int i = 0; i < k; ++i) by_degree[i] = i;
+        std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) { return degree[a] > degree[b]; });
+        local.resize(k);
+        for (int i = 0; i < k; ++i) {
+            local[i] = cand[by_degree[i]];
+            local_of[local[i]] = i;
+        }
+        rows.assign((size_t)k * W, 0);
+        for (int i = 0; i < k; ++i) {
+            uint64_t* row = &rows[(size_t)i * W];
+            for (int w : adj[local[i]]) {
+                const int j = local_of[w];
+                if (j >= 0) row[j >> 6] |= 1ULL << (j & 63);
+            }
+        }
+        for (int u : cand) local_of[u] = -1;
+
+        // The search is at most k deep; the outer vectors must not grow
+        // under references held by enclosing frames.
+        ensure_depth(k + 1);
+        P[0].assign(W, 0);
+        U[0].resize(W);
+        Q[0].resize(W);
+        for (int i = 0; i < k; ++i) P[0][i >> 6] |= 1ULL << (i & 63);
+        C.assign(1, v);
+        expand(0);
+    }
+};
+
+}  // namespace max_clique_detail
+
+// Returns a maximum clique of the graph (sorted), searching with `threads`
+// workers.
+inline std::vector<int> maximum_clique(const CSRGraph& adj, int threads = 1) {
+    const int n = adj.size();
+    threads = std::max(1, threads);
+    std::vector<int> core;
+    const std::vector<int> order =
+        threads > 1 ? parallel_core_decomposition(adj, threads, &core) : core_decomposition(adj, &core);
+    std::vector<int> pos(n);
+    for (int i = 0; i < n; ++i) pos[order[i]] = i;
+
+    // Roots from the end of the order, where the cores are deepest, so a
+    // large incumbent turns up early.
+    max_clique_detail::Incumbent incumbent;
+    std::atomic<int> next{n - 1};
+    auto work = [&]() {
+        max_clique_detail::Search search(adj, incumbent);
+        std::vector<int> cand;
+        for (int i = next.fetch_sub(1); i >= 0; i = next.fetch_sub(1)) {
+            const int v = order[i];
+            if (core[v] + 1 <= incumbent.size()) continue;
+            cand.clear();
+            // A member of a clique bigger than the incumbent has a core
+            // number of at least the incumbent's size.
+            for (int w : adj[v]) {
+                if (pos[w] > i && core[w] >= incumbent.size()) cand.push_back(w);
+            }
+            search.root(v, cand);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (auto& w : workers) w.join();
+
+    std::vector<int> clique = incumbent.clique();
+    std::sort(clique.begin(), clique.end());
+    return clique;
+}
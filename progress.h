@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "clique.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Peak resident set size of the process in megabytes (0 where unknown).
+inline double peak_memory_mb() {
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+        return usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+    return 0;
+}
+
+// Heartbeat thread that prints a CliqueProgress every `interval` seconds:
+// roots done, cliques and cliques/sec since the last beat, current depth,
+// peak memory and an ETA extrapolated from the root rate. Lines go to
+// stderr, or replace the contents of a status file if one is given. The
+// enumeration only ever writes the counters; the reporter only reads them.
+class ProgressReporter {
+    const CliqueProgress& progress;
+    const double interval;
+    const std::string status_path;
+    std::mutex m;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread worker;
+
+    std::string line(double elapsed, double rate) const {
+        const uint64_t done = progress.roots_done.load(std::memory_order_relaxed);
+        const uint64_t total = progress.roots_total.load(std::memory_order_relaxed);
+        char buf[256];
+        int len = snprintf(buf, sizeof buf, "[%.1fs] roots %llu/%llu", elapsed, (unsigned long long)done,
+                           (unsigned long long)total);
+        if (total) len += snprintf(buf + len, sizeof buf - len, " (%.1f%%)", 100.0 * done / total);
+        len += snprintf(buf + len, sizeof buf - len, ", cliques %llu (%.0f/s), depth %d, peak %.1f MB",
+                        (unsigned long long)progress.cliques.load(std::memory_order_relaxed), rate,
+                        progress.depth.load(std::memory_order_relaxed), peak_memory_mb());
+        if (done && total > done) {
+            snprintf(buf + len, sizeof buf - len, ", ETA %.0fs", elapsed * (total - done) / done);
+        }
+        return buf;
+    }
+
+    void loop() {
+        using namespace std::chrono;
+        const auto start = steady_clock::now();
+        auto last = start;
+        uint64_t last_cliques = 0;
+        std::unique_lock<std::mutex> lock(m);
+        while (!wake.wait_for(lock, duration<double>(interval), [&] { return stopping; })) {
+            const auto now = steady_clock::now();
+            const uint64_t cliques = progress.cliques.load(std::memory_order_relaxed);
+            const double rate = (cliques - last_cliques) / duration<double>(now - last).count();
+            const std::string text = line(duration<double>(now - start).count(), rate);
+            if (status_path.empty()) {
+                std::cerr << text << std::endl;
+            } else {
+                std::ofstream(status_path) << text << "\n";
+            }
+            last = now;
+            last_cliques = cliques;
+        }
+    }
+
+public:
+    ProgressReporter(const CliqueProgress& progress_, double interval_seconds, std::string status_file = "")
+        : progress(progress_), interval(interval_seconds), status_path(std::move(status_file)) {
+        worker = std::thread(&ProgressReporter::loop, this);
+    }
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    ~ProgressReporter() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+};
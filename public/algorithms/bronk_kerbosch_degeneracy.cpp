@@ -1,314 +1,506 @@
-#include <bits/stdc++.h>
-#include <chrono>
-using namespace std;
-
-typedef long long ll;
-
-// ---------------------------------------------------------------------
-// Optional BFS and DSU code from your template (not used for Bron–Kerbosch)
-
-vector<ll> dsu_rank_ds, parentDSU;
-void initializeDSU(ll n) {
-    parentDSU.resize(n);
-    dsu_rank_ds.resize(n, 0);
-    for(ll i = 0; i < n; i++) {
-        parentDSU[i] = i;
-    }
-}
-ll find_par(ll u) {
-    if(parentDSU[u] == u) return u;
-    return parentDSU[u] = find_par(parentDSU[u]);
-}
-void unite(ll u, ll v) {
-    u = find_par(u);
-    v = find_par(v);
-    if(u == v) return;
-    if(dsu_rank_ds[u] > dsu_rank_ds[v]) {
-        parentDSU[v] = u;
-    } else if(dsu_rank_ds[u] < dsu_rank_ds[v]) {
-        parentDSU[u] = v;
-    } else {
-        parentDSU[u] = v;
-        dsu_rank_ds[v]++;
-    }
-}
-bool same(ll u, ll v) {
-    return find_par(u) == find_par(v);
-}
-void bfs(ll src, vector<vector<ll>>& adj, vector<ll>& vis) {
-    vis[src] = 1;
-    queue<pair<ll, ll>> q;
-    q.push({src, 0});
-    while(!q.empty()) {
-        ll node = q.front().first;
-        ll level = q.front().second; // level is unused, but included for completeness
-        q.pop();
-        for(ll neighbor : adj[node]) {
-            if(!vis[neighbor]) {
-                vis[neighbor] = 1;
-                q.push({neighbor, level + 1});
-            }
-        }
-    }
-}
-// ---------------------------------------------------------------------
-
-// Global adjacency list
-static vector<vector<ll>> adj;
-// Stores all maximal cliques found by Bron–Kerbosch
-static vector<vector<ll>> allCliques;
-
-/*
- * getDegeneracyOrdering:
- *   Computes a degeneracy ordering of 'graph' in O(n + m) time using a standard
- *   "peeling" procedure:
- *      - Maintain buckets of vertices grouped by their current degree
- *      - Repeatedly remove one vertex of minimum degree, update neighbors
- */
-vector<ll> getDegeneracyOrdering(const vector<vector<ll>>& graph) {
-    ll n = (ll)graph.size();
-    vector<ll> deg(n, 0);
-    ll maxDeg = 0;
-
-    // Compute degrees, track max degree
-    for(ll i = 0; i < n; i++) {
-        deg[i] = (ll)graph[i].size();
-        maxDeg = max(maxDeg, deg[i]);
-    }
-
-    // Buckets D[k] for vertices of degree k
-    vector<vector<ll>> D(maxDeg + 1);
-    for(ll v = 0; v < n; v++) {
-        D[deg[v]].push_back(v);
-    }
-
-    vector<bool> removed(n, false);
-    vector<ll> ordering;
-    ordering.reserve(n);
-
-    ll currentDeg = 0;
-    // Peel off all vertices
-    for(ll i = 0; i < n; i++) {
-        // find non-empty bucket
-        while(currentDeg <= maxDeg && D[currentDeg].empty()) {
-            currentDeg++;
-        }
-        // take one vertex from D[currentDeg]
-        ll v = D[currentDeg].back();
-        D[currentDeg].pop_back();
-        removed[v] = true;
-        ordering.push_back(v);
-
-        // update neighbors
-        for(ll nbr : graph[v]) {
-            if(!removed[nbr]) {
-                ll oldDeg = deg[nbr];
-                ll newDeg = oldDeg - 1;
-                deg[nbr] = newDeg;
-                
-                // Remove from old bucket and add to new bucket
-                auto it = find(D[oldDeg].begin(), D[oldDeg].end(), nbr);
-                if(it != D[oldDeg].end()) {
-                    D[oldDeg].erase(it);
-                }
-                D[newDeg].push_back(nbr);
-            }
-        }
-    }
-    return ordering;
-}
-
-/*
- * bronKerboschPivot:
- *   Standard Bron–Kerbosch with pivoting (Tomita style).
- *   Finds and stores all maximal cliques containing R and considering P ∪ X.
- */
-void bronKerboschPivot(vector<ll>& R, vector<ll>& P, vector<ll>& X) {
-    // If P and X are both empty, we've found a maximal clique
-    if(P.empty() && X.empty()) {
-        allCliques.push_back(R);
-        return;
-    }
-
-    // Pick a pivot 'u' from P or X
-    ll u = -1;
-    if(!P.empty()) {
-        u = P[0];
-    } else if(!X.empty()) {
-        u = X[0];
-    }
-
-    // Initialize locally to avoid issues with recursion
-    vector<bool> isNeighbor(adj.size(), false);
-    
-    // Mark neighbors of u
-    for(ll nbr : adj[u]) {
-        isNeighbor[nbr] = true;
-    }
-
-    // We'll only recurse on vertices in (P \ neighbors(u))
-    vector<ll> expandList;
-    expandList.reserve(P.size());
-    for(ll v : P) {
-        if(!isNeighbor[v]) {
-            expandList.push_back(v);
-        }
-    }
-
-    for(ll v : expandList) {
-        // Include v in clique
-        R.push_back(v);
-
-        // Build P' = P ∩ Γ(v), X' = X ∩ Γ(v)
-        vector<ll> newP, newX;
-        newP.reserve(P.size());
-        newX.reserve(X.size());
-
-        // Initialize locally to avoid issues with recursion
-        vector<bool> isNeighborV(adj.size(), false);
-        
-        // Mark neighbors of v
-        for(ll nbr : adj[v]) {
-            isNeighborV[nbr] = true;
-        }
-
-        // P'
-        for(ll w : P) {
-            if(w != v && isNeighborV[w]) {
-                newP.push_back(w);
-            }
-        }
-        // X'
-        for(ll w : X) {
-            if(isNeighborV[w]) {
-                newX.push_back(w);
-            }
-        }
-
-        // Recurse
-        bronKerboschPivot(R, newP, newX);
-
-        // Backtrack: remove v from R
-        R.pop_back();
-
-        // Move v from P to X
-        auto it = find(P.begin(), P.end(), v);
-        if(it != P.end()) {
-            P.erase(it);
-        }
-        X.push_back(v);
-    }
-}
-
-/*
- * bronKerboschDegeneracy:
- *   Implements the Eppstein–Löffler–Strash strategy:
- *   For each vertex v in degOrder:
- *     - Partition neighbors into P (later in degOrder) and X (earlier)
- *     - R = {v}
- *     - bronKerboschPivot(R, P, X)
- */
-void bronKerboschDegeneracy(const vector<ll>& degOrder) {
-    ll n = (ll)adj.size();
-    // Precompute positions in degOrder
-    vector<ll> pos(n);
-    for(ll i = 0; i < n; i++) {
-        pos[degOrder[i]] = i;
-    }
-
-    // For each vertex v in degOrder
-    for(ll i = 0; i < n; i++) {
-        ll v = degOrder[i];
-
-        vector<ll> P, X;
-        for(ll nbr : adj[v]) {
-            // if nbr comes after v in degOrder => belongs to P
-            if(pos[nbr] > i) {
-                P.push_back(nbr);
-            }
-            // if nbr comes before v => belongs to X
-            else if(pos[nbr] < i) {
-                X.push_back(nbr);
-            }
-        }
-
-        // R starts as {v}
-        vector<ll> R;
-        R.push_back(v);
-
-        bronKerboschPivot(R, P, X);
-    }
-}
-
-// ---------------------------------------------------------------------
-// Main with more accurate time measurements for each step
-// ---------------------------------------------------------------------
-int main() {
-    using namespace std::chrono;
-
-    // Start overall timer right away
-    auto T0 = high_resolution_clock::now();
-
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    // ------------------ Read input ------------------
-    ll n, m;
-    cin >> n >> m;
-    adj.clear();
-    adj.resize(n);
-    for(ll i = 0; i < m; i++) {
-        ll x, y;
-        cin >> x >> y;
-        x--;  // switch to 0-based
-        y--;
-        adj[x].push_back(y);
-        adj[y].push_back(x);
-    }
-    auto T1 = high_resolution_clock::now();
-
-    // ------------------ Degeneracy ordering ------------------
-    vector<ll> degOrder = getDegeneracyOrdering(adj);
-    auto T2 = high_resolution_clock::now();
-
-    // ------------------ Bron–Kerbosch ------------------
-    allCliques.clear();
-    bronKerboschDegeneracy(degOrder);
-    auto T3 = high_resolution_clock::now();
-
-    // ------------------ Print results ------------------
-    // Format: clique: {v1, v2, ...} with 1-based indices
-    for(const auto &clique : allCliques) {
-        cout << "clique: {";
-        for(size_t i = 0; i < clique.size(); i++) {
-            cout << (clique[i] + 1);
-            if(i + 1 < clique.size()) {
-                cout << ", ";
-            }
-        }
-        cout << "}\n";
-    }
-    auto T4 = high_resolution_clock::now();
-
-    // ------------------ Timing summary ------------------
-    // Convert all intervals to microseconds
-    ll inputMicros    = duration_cast<microseconds>(T1 - T0).count();
-    ll degeneracyMicros = duration_cast<microseconds>(T2 - T1).count();
-    ll bkMicros       = duration_cast<microseconds>(T3 - T2).count();
-    ll printMicros    = duration_cast<microseconds>(T4 - T3).count();
-    ll totalMicros    = duration_cast<microseconds>(T4 - T0).count();
-
-    // Print them
-    cout << "\n--- Profiling Information (microseconds) ---\n";
-    cout << "1) Reading input:   " << inputMicros << " µs\n";
-    cout << "2) Degeneracy:      " << degeneracyMicros << " µs\n";
-    cout << "3) Bron-Kerbosch:   " << bkMicros << " µs\n";
-    cout << "4) Printing cliques:" << printMicros << " µs\n";
-    cout << "Total (T4 - T0):     " << totalMicros << " µs\n";
-
-    // Optional: show how these add up
-    ll sumParts = degeneracyMicros + bkMicros + printMicros;
-    cout << "Sum of sub-steps:    " << sumParts << " µs\n";
-
-    return 0;
-}
+#include <bits/stdc++.h>
+#include <chrono>
+using namespace std;
+
+typedef long long ll;
+
+// Called once per search-tree node; the benchmark defines it to count them.
+#ifndef BK_SEARCH_NODE
+#define BK_SEARCH_NODE()
+#endif
+
+// ---------------------------------------------------------------------
+// Optional BFS and DSU code from your template (not used for Bron–Kerbosch)
+
+vector<ll> dsu_rank_ds, parentDSU;
+void initializeDSU(ll n) {
+    parentDSU.resize(n);
+    dsu_rank_ds.resize(n, 0);
+    for(ll i = 0; i < n; i++) {
+        parentDSU[i] = i;
+    }
+}
+ll find_par(ll u) {
+    if(parentDSU[u] == u) return u;
+    return parentDSU[u] = find_par(parentDSU[u]);
+}
+void unite(ll u, ll v) {
+    u = find_par(u);
+    v = find_par(v);
+    if(u == v) return;
+    if(dsu_rank_ds[u] > dsu_rank_ds[v]) {
+        parentDSU[v] = u;
+    } else if(dsu_rank_ds[u] < dsu_rank_ds[v]) {
+        parentDSU[u] = v;
+    } else {
+        parentDSU[u] = v;
+        dsu_rank_ds[v]++;
+    }
+}
+bool same(ll u, ll v) {
+    return find_par(u) == find_par(v);
+}
+void bfs(ll src, vector<vector<ll>>& adj, vector<ll>& vis) {
+    vis[src] = 1;
+    queue<pair<ll, ll>> q;
+    q.push({src, 0});
+    while(!q.empty()) {
+        ll node = q.front().first;
+        ll level = q.front().second; // level is unused, but included for completeness
+        q.pop();
+        for(ll neighbor : adj[node]) {
+            if(!vis[neighbor]) {
+                vis[neighbor] = 1;
+                q.push({neighbor, level + 1});
+            }
+        }
+    }
+}
+// ---------------------------------------------------------------------
+
+// Global adjacency list
+static vector<vector<ll>> adj;
+
+// ---------------------------------------------------------------------
+// Clique output sinks
+//
+// Cliques are streamed to stdout as soon as they are found instead of being
+// collected first. Text and binary sinks encode into a large buffer; full
+// buffers are handed to a background thread that does the actual writes, so
+// enumeration only stalls when the writer falls several buffers behind.
+
+class AsyncWriter {
+    static const size_t kMaxQueued = 4;
+    FILE* out;
+    mutex m;
+    condition_variable changed;
+    deque<string> queue;
+    bool closing = false;
+    thread worker;
+
+    void run() {
+        unique_lock<mutex> lock(m);
+        while (true) {
+            changed.wait(lock, [&] { return closing || !queue.empty(); });
+            if (queue.empty()) break;
+            string chunk = move(queue.front());
+            queue.pop_front();
+            changed.notify_all();
+            lock.unlock();
+            fwrite(chunk.data(), 1, chunk.size(), out);
+            lock.lock();
+        }
+        fflush(out);
+    }
+
+public:
+    explicit AsyncWriter(FILE* out_) : out(out_), worker(&AsyncWriter::run, this) {}
+    ~AsyncWriter() { close(); }
+
+    // Queues a chunk for writing; blocks while kMaxQueued chunks are pending.
+    void write(string&& chunk) {
+        unique_lock<mutex> lock(m);
+        changed.wait(lock, [&] { return queue.size() < kMaxQueued; });
+        queue.push_back(move(chunk));
+        changed.notify_all();
+    }
+
+    // Writes out everything queued so far and stops the thread.
+    void close() {
+        {
+            lock_guard<mutex> lock(m);
+            if (closing) return;
+            closing = true;
+        }
+        changed.notify_all();
+        worker.join();
+    }
+};
+
+class CliqueSink {
+public:
+    ll count = 0;
+    virtual ~CliqueSink() {}
+    virtual void emit(const vector<ll>&) { count++; }
+    // Called once after the last clique; everything is written on return.
+    virtual void finish() {}
+};
+
+// Count-only sink: nothing is written.
+class CountSink : public CliqueSink {};
+
+// Base for sinks that encode into a buffer drained by an AsyncWriter.
+class BufferedSink : public CliqueSink {
+    static const size_t kBufferSize = 1 << 22;
+    AsyncWriter writer;
+
+protected:
+    string buffer;
+
+    void flushIfFull() {
+        if (buffer.size() >= kBufferSize) {
+            writer.write(move(buffer));
+            buffer.clear();
+            buffer.reserve(kBufferSize + 4096);
+        }
+    }
+
+public:
+    BufferedSink() : writer(stdout) { buffer.reserve(kBufferSize + 4096); }
+
+    void finish() override {
+        if (!buffer.empty()) writer.write(move(buffer));
+        buffer.clear();
+        writer.close();
+    }
+};
+
+// Binary sink: per clique, LEB128 varints of its size, its smallest vertex
+// and then the gaps between consecutive vertices in increasing order.
+class BinarySink : public BufferedSink {
+    vector<ll> sorted;
+
+    void putVarint(unsigned long long x) {
+        while (x >= 0x80) {
+            buffer.push_back(char((x & 0x7f) | 0x80));
+            x >>= 7;
+        }
+        buffer.push_back(char(x));
+    }
+
+public:
+    void emit(const vector<ll>& clique) override {
+        count++;
+        sorted.assign(clique.begin(), clique.end());
+        sort(sorted.begin(), sorted.end());
+        putVarint(sorted.size());
+        ll prev = 0;
+        for (ll v : sorted) {
+            putVarint(v + 1 - prev);
+            prev = v + 1;
+        }
+        flushIfFull();
+    }
+};
+
+// Appends the decimal form of x to s.
+void appendNumber(string& s, ll x) {
+    char digits[24];
+    int len = 0;
+    do {
+        digits[len++] = char('0' + x % 10);
+        x /= 10;
+    } while (x > 0);
+    while (len > 0) s.push_back(digits[--len]);
+}
+
+// Text sink: one "clique: {v1, v2, ...}" line per clique, 1-based ids.
+class TextSink : public BufferedSink {
+public:
+    void emit(const vector<ll>& clique) override {
+        count++;
+        buffer += "clique: {";
+        for(size_t i = 0; i < clique.size(); i++) {
+            appendNumber(buffer, clique[i] + 1);
+            if(i + 1 < clique.size()) {
+                buffer += ", ";
+            }
+        }
+        buffer += "}\n";
+        flushIfFull();
+    }
+};
+
+// Picks the sink for the optional command-line mode; nullptr if unknown.
+CliqueSink* makeSink(const string& mode) {
+    if(mode == "text") return new TextSink();
+    if(mode == "binary") return new BinarySink();
+    if(mode == "count") return new CountSink();
+    return nullptr;
+}
+// ---------------------------------------------------------------------
+
+// Receives every maximal clique found by Bron–Kerbosch
+static CliqueSink* sink = nullptr;
+
+/*
+ * getDegeneracyOrdering:
+ *   Computes a degeneracy ordering of 'graph' in O(n + m) time using the
+ *   Batagelj–Zaversnik bucket peel:
+ *      - vert[] holds the vertices sorted by current degree, bin[d] is the
+ *        index in vert[] where the vertices of degree d start, and pos[v]
+ *        is v's index in vert[]
+ *      - Vertices are removed in vert[] order; when a neighbour's degree
+ *        drops it is swapped to the front of its bucket and the bucket
+ *        boundary moves past it, so every update is O(1)
+ */
+vector<ll> getDegeneracyOrdering(const vector<vector<ll>>& graph) {
+    ll n = (ll)graph.size();
+    vector<ll> deg(n, 0);
+    ll maxDeg = 0;
+
+    // Compute degrees, track max degree
+    for(ll i = 0; i < n; i++) {
+        deg[i] = (ll)graph[i].size();
+        maxDeg = max(maxDeg, deg[i]);
+    }
+
+    // Counting sort of the vertices by degree
+    vector<ll> bin(maxDeg + 1, 0);
+    for(ll v = 0; v < n; v++) {
+        bin[deg[v]]++;
+    }
+    ll start = 0;
+    for(ll d = 0; d <= maxDeg; d++) {
+        ll count = bin[d];
+        bin[d] = start;
+        start += count;
+    }
+    vector<ll> vert(n), pos(n);
+    for(ll v = 0; v < n; v++) {
+        pos[v] = bin[deg[v]]++;
+        vert[pos[v]] = v;
+    }
+    // Restore bin[d] to the start of bucket d
+    for(ll d = maxDeg; d > 0; d--) {
+        bin[d] = bin[d - 1];
+    }
+    if(maxDeg >= 0) bin[0] = 0;
+
+    vector<ll> ordering;
+    ordering.reserve(n);
+
+    // Peel off all vertices in bucket order
+    for(ll i = 0; i < n; i++) {
+        ll v = vert[i];
+        ordering.push_back(v);
+
+        // update neighbors that are still in a higher bucket
+        for(ll nbr : graph[v]) {
+            if(deg[nbr] > deg[v]) {
+                ll d = deg[nbr];
+                ll pn = pos[nbr];
+                ll pw = bin[d];
+                ll w = vert[pw];
+                // Swap nbr to the front of its bucket, then shrink the bucket
+                if(nbr != w) {
+                    pos[nbr] = pw;
+                    vert[pw] = nbr;
+                    pos[w] = pn;
+                    vert[pn] = w;
+                }
+                bin[d]++;
+                deg[nbr]--;
+            }
+        }
+    }
+    return ordering;
+}
+
+// Epoch-stamped neighbour marks shared by every search node: a vertex w is
+// marked iff markEpoch[w] == currentEpoch, so starting a new mark set is a
+// single increment instead of an O(n) clear.
+static vector<ll> markEpoch;
+static ll currentEpoch = 0;
+
+// Marks exactly the neighbours of v.
+void markNeighbors(ll v) {
+    currentEpoch++;
+    for(ll nbr : adj[v]) {
+        markEpoch[nbr] = currentEpoch;
+    }
+}
+
+bool isMarked(ll w) {
+    return markEpoch[w] == currentEpoch;
+}
+
+/*
+ * bronKerboschPivot:
+ *   Standard Bron–Kerbosch with pivoting (Tomita style).
+ *   Finds and stores all maximal cliques containing R and considering P ∪ X.
+ *   Each node costs O(|P| + |X| + deg) work: neighbour tests go through the
+ *   shared epoch marks, which are only needed until the child's P' and X'
+ *   are built, so recursion is free to reuse them.
+ */
+void bronKerboschPivot(vector<ll>& R, vector<ll>& P, vector<ll>& X) {
+    BK_SEARCH_NODE();
+    // If P and X are both empty, we've found a maximal clique
+    if(P.empty() && X.empty()) {
+        sink->emit(R);
+        return;
+    }
+
+    // Pick a pivot 'u' from P or X
+    ll u = -1;
+    if(!P.empty()) {
+        u = P[0];
+    } else if(!X.empty()) {
+        u = X[0];
+    }
+
+    // We'll only recurse on vertices in (P \ neighbors(u))
+    markNeighbors(u);
+    vector<ll> expandList;
+    expandList.reserve(P.size());
+    for(ll v : P) {
+        if(!isMarked(v)) {
+            expandList.push_back(v);
+        }
+    }
+
+    for(ll v : expandList) {
+        // Include v in clique
+        R.push_back(v);
+
+        // Build P' = P ∩ Γ(v), X' = X ∩ Γ(v)
+        vector<ll> newP, newX;
+        newP.reserve(P.size());
+        newX.reserve(X.size());
+
+        markNeighbors(v);
+
+        // P'
+        for(ll w : P) {
+            if(w != v && isMarked(w)) {
+                newP.push_back(w);
+            }
+        }
+        // X'
+        for(ll w : X) {
+            if(isMarked(w)) {
+                newX.push_back(w);
+            }
+        }
+
+        // Recurse
+        bronKerboschPivot(R, newP, newX);
+
+        // Backtrack: remove v from R
+        R.pop_back();
+
+        // Move v from P to X
+        auto it = find(P.begin(), P.end(), v);
+        if(it != P.end()) {
+            P.erase(it);
+        }
+        X.push_back(v);
+    }
+}
+
+/*
+ * bronKerboschDegeneracy:
+ *   Implements the Eppstein–Löffler–Strash strategy:
+ *   For each vertex v in degOrder:
+ *     - Partition neighbors into P (later in degOrder) and X (earlier)
+ *     - R = {v}
+ *     - bronKerboschPivot(R, P, X)
+ */
+void bronKerboschDegeneracy(const vector<ll>& degOrder) {
+    ll n = (ll)adj.size();
+    markEpoch.assign(n, 0);
+    currentEpoch = 0;
+
+    // Precompute positions in degOrder
+    vector<ll> pos(n);
+    for(ll i = 0; i < n; i++) {
+        pos[degOrder[i]] = i;
+    }
+
+    // For each vertex v in degOrder
+    for(ll i = 0; i < n; i++) {
+        ll v = degOrder[i];
+
+        vector<ll> P, X;
+        for(ll nbr : adj[v]) {
+            // if nbr comes after v in degOrder => belongs to P
+            if(pos[nbr] > i) {
+                P.push_back(nbr);
+            }
+            // if nbr comes before v => belongs to X
+            else if(pos[nbr] < i) {
+                X.push_back(nbr);
+            }
+        }
+
+        // R starts as {v}
+        vector<ll> R;
+        R.push_back(v);
+
+        bronKerboschPivot(R, P, X);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Main with more accurate time measurements for each step
+// ---------------------------------------------------------------------
+int main(int argc, char** argv) {
+    using namespace std::chrono;
+
+    // Output mode: text (default), binary or count
+    string mode = argc > 1 ? argv[1] : "text";
+    unique_ptr<CliqueSink> output(makeSink(mode));
+    if(!output || argc > 2) {
+        cerr << "Usage: " << argv[0] << " [text|binary|count] < graph\n";
+        return 1;
+    }
+    sink = output.get();
+
+    // Start overall timer right away
+    auto T0 = high_resolution_clock::now();
+
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    // ------------------ Read input ------------------
+    ll n, m;
+    cin >> n >> m;
+    adj.clear();
+    adj.resize(n);
+    for(ll i = 0; i < m; i++) {
+        ll x, y;
+        cin >> x >> y;
+        x--;  // switch to 0-based
+        y--;
+        adj[x].push_back(y);
+        adj[y].push_back(x);
+    }
+    auto T1 = high_resolution_clock::now();
+
+    // ------------------ Degeneracy ordering ------------------
+    vector<ll> degOrder = getDegeneracyOrdering(adj);
+    auto T2 = high_resolution_clock::now();
+
+    // ------------------ Bron–Kerbosch ------------------
+    bronKerboschDegeneracy(degOrder);
+    auto T3 = high_resolution_clock::now();
+
+    // ------------------ Flush results ------------------
+    // Cliques were streamed while enumerating; wait for the last writes.
+    sink->finish();
+    auto T4 = high_resolution_clock::now();
+
+    // ------------------ Timing summary ------------------
+    // Convert all intervals to microseconds
+    ll inputMicros    = duration_cast<microseconds>(T1 - T0).count();
+    ll degeneracyMicros = duration_cast<microseconds>(T2 - T1).count();
+    ll bkMicros       = duration_cast<microseconds>(T3 - T2).count();
+    ll printMicros    = duration_cast<microseconds>(T4 - T3).count();
+    ll totalMicros    = duration_cast<microseconds>(T4 - T0).count();
+
+    // Print them (to stderr in binary mode, to keep stdout a clean stream)
+    ostream& info = mode == "binary" ? cerr : cout;
+    info << "\n--- Profiling Information (microseconds) ---\n";
+    info << "Maximal cliques:    " << sink->count << "\n";
+    info << "1) Reading input:   " << inputMicros << " µs\n";
+    info << "2) Degeneracy:      " << degeneracyMicros << " µs\n";
+    info << "3) Bron-Kerbosch:   " << bkMicros << " µs\n";
+    info << "4) Printing cliques:" << printMicros << " µs\n";
+    info << "Total (T4 - T0):     " << totalMicros << " µs\n";
+
+    // Optional: show how these add up
+    ll sumParts = degeneracyMicros + bkMicros + printMicros;
+    info << "Sum of sub-steps:    " << sumParts << " µs\n";
+
+    return 0;
+}
@@ -1,267 +1,652 @@
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <algorithm>
-#include <chrono>
-#include <string>
-#include <stack>
-#include <sstream>
-#include <iomanip>
-#include <numeric>
-
-using namespace std;
-using namespace chrono;
-
-vector<vector<int>> adj;
-vector<int> pos;
-vector<int> clique_sizes;
-int largest_clique_size = 0;
-
-struct State {
-    vector<int> P;
-    vector<int> R;
-    vector<int> X;
-    State(vector<int> P_, vector<int> R_, vector<int> X_)
-        : P(move(P_)), R(move(R_)), X(move(X_)) {}
-};
-
-void intersect(const vector<int>& a, const vector<int>& b, vector<int>& res) {
-    res.clear();
-    auto it = a.begin();
-    auto jt = b.begin();
-    while (it != a.end() && jt != b.end()) {
-        if (*it < *jt) ++it;
-        else if (*it > *jt) ++jt;
-        else {
-            res.push_back(*it);
-            ++it;
-            ++jt;
-        }
-    }
-}
-
-void set_difference(const vector<int>& a, const vector<int>& b, vector<int>& res) {
-    res.clear();
-    auto it = a.begin();
-    auto jt = b.begin();
-    while (it != a.end() && jt != b.end()) {
-        if (*it < *jt) {
-            res.push_back(*it);
-            ++it;
-        } else if (*it > *jt) {
-            ++jt;
-        } else {
-            ++it;
-            ++jt;
-        }
-    }
-    while (it != a.end()) {
-        res.push_back(*it);
-        ++it;
-    }
-}
-
-void bronKerboschPivotIterative(vector<int>& P, vector<int>& R, vector<int>& X) {
-    stack<State> st;
-    st.emplace(P, R, X);
-
-    while (!st.empty()) {
-        auto current = move(st.top());
-        st.pop();
-
-        if (current.P.empty() && current.X.empty()) {
-            const int clique_size = current.R.size();
-            if (clique_size >= 2) {
-                largest_clique_size = max(largest_clique_size, clique_size);
-                if (clique_sizes.size() <= clique_size) {
-                    clique_sizes.resize(clique_size + 1);
-                }
-                clique_sizes[clique_size]++;
-            }
-            continue;
-        }
-
-        vector<int> PuX;
-        PuX.reserve(current.P.size() + current.X.size());
-        merge(current.P.begin(), current.P.end(),
-              current.X.begin(), current.X.end(),
-              back_inserter(PuX));
-        auto last = unique(PuX.begin(), PuX.end());
-        PuX.erase(last, PuX.end());
-
-        int u = PuX.empty() ? -1 : PuX.front();
-        vector<int> P_diff;
-
-        if (u != -1) set_difference(current.P, adj[u], P_diff);
-        else P_diff = current.P;
-
-        for (int v : P_diff) {
-            vector<int> newP, newX, newR;
-            intersect(current.P, adj[v], newP);
-            intersect(current.X, adj[v], newX);
-            newR = current.R;
-            newR.push_back(v);
-            st.emplace(move(newP), move(newR), move(newX));
-
-            auto it_p = lower_bound(current.P.begin(), current.P.end(), v);
-            if (it_p != current.P.end() && *it_p == v) {
-                current.P.erase(it_p);
-            }
-            current.X.insert(upper_bound(current.X.begin(), current.X.end(), v), v);
-        }
-    }
-}
-
-void readGraph(const string& filename, int& n) {
-    ifstream file(filename);
-    string line;
-    int max_node = -1;
-
-    while (getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        istringstream iss(line);
-        int a, b;
-        if (!(iss >> a >> b)) continue;
-        max_node = max(max_node, max(a, b));
-    }
-
-    n = max_node + 1;
-    adj.resize(n);
-    file.clear();
-    file.seekg(0);
-
-    while (getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        istringstream iss(line);
-        int a, b;
-        if (!(iss >> a >> b)) continue;
-        if (a != b) {
-            adj[a].push_back(b);
-            adj[b].push_back(a);
-        }
-    }
-
-    for (auto& list : adj) {
-        sort(list.begin(), list.end());
-        auto last = unique(list.begin(), list.end());
-        list.erase(last, list.end());
-    }
-}
-
-vector<int> coreDecomposition(int n) {
-    vector<int> degree(n);
-    for (int i = 0; i < n; ++i) degree[i] = adj[i].size();
-
-    int max_degree = *max_element(degree.begin(), degree.end());
-    vector<int> bin(max_degree + 2, 0);
-    for (int d : degree) bin[d + 1]++;
-    for (int d = 0; d <= max_degree; ++d) bin[d + 1] += bin[d];
-
-    vector<int> vert(n), pos_arr(n);
-    for (int i = 0; i < n; ++i) {
-        pos_arr[i] = bin[degree[i]]++;
-        vert[pos_arr[i]] = i;
-    }
-
-    for (int d = max_degree; d >= 1; --d) bin[d] = bin[d - 1];
-    bin[0] = 0;
-
-    vector<int> order;
-    for (int i = 0; i < n; ++i) {
-        int v = vert[i];
-        order.push_back(v);
-        for (int u : adj[v]) {
-            if (degree[u] > degree[v]) {
-                int du = degree[u];
-                int pu = pos_arr[u];
-                int pw = bin[du];
-                int w = vert[pw];
-                if (u != w) {
-                    pos_arr[u] = pw;
-                    pos_arr[w] = pu;
-                    vert[pu] = w;
-                    vert[pw] = u;
-                }
-                bin[du]++;
-                degree[u]--;
-            }
-        }
-    }
-    return order;
-}
-
-void saveResults(const time_point<high_resolution_clock>& start,
-                const time_point<high_resolution_clock>& read_time,
-                const time_point<high_resolution_clock>& core_time,
-                const time_point<high_resolution_clock>& pos_time,
-                const time_point<high_resolution_clock>& bk_time) {
-    ofstream clique_file("clique_sizes.txt");
-    for (size_t i = 2; i < clique_sizes.size(); ++i) {
-        if (clique_sizes[i] > 0) {
-            clique_file << i << " " << clique_sizes[i] << "\n";
-        }
-    }
-    clique_file.close();
-
-    ofstream profile_file("profiling.txt");
-    profile_file << "==== PROFILING ====\n";
-    profile_file << "Read time: " 
-                << duration_cast<milliseconds>(read_time - start).count() 
-                << " ms\n";
-    profile_file << "Core decomposition: " 
-                << duration_cast<milliseconds>(core_time - read_time).count() 
-                << " ms\n";
-    profile_file << "Position computation: " 
-                << duration_cast<milliseconds>(pos_time - core_time).count() 
-                << " ms\n";
-    profile_file << "Bron-Kerbosch time: " 
-                << duration_cast<milliseconds>(bk_time - pos_time).count() 
-                << " ms\n";
-    profile_file.close();
-}
-
-int main(int argc, char** argv) {
-    if (argc != 2) {
-        cerr << "Usage: " << argv[0] << " <input_file>" << endl;
-        return 1;
-    }
-
-    auto start = high_resolution_clock::now();
-    int n = 0;
-    readGraph(argv[1], n);
-    auto read_time = high_resolution_clock::now();
-    cout << "Dataset Read Sucessfully\n";
-
-    vector<int> order = coreDecomposition(n);
-    auto core_time = high_resolution_clock::now();
-
-    pos.resize(n);
-    for (int i = 0; i < n; ++i) pos[order[i]] = i;
-    auto pos_time = high_resolution_clock::now();
-
-    for (int i = 0; i < n; ++i) {
-        int v_i = order[i];
-        vector<int> P, X;
-        for (int w : adj[v_i]) {
-            if (pos[w] > i) P.push_back(w);
-            else X.push_back(w);
-        }
-        sort(P.begin(), P.end());
-        sort(X.begin(), X.end());
-        vector<int> R = {v_i};
-        bronKerboschPivotIterative(P, R, X);
-    }
-    auto bk_time = high_resolution_clock::now();
-
-    int total_cliques = accumulate(clique_sizes.begin(), clique_sizes.end(), 0);
-    cout << "==== RESULTS ====\n"
-         << "Largest Clique Size: " << largest_clique_size << "\n"
-         << "Total Maximal Cliques: " << total_cliques << "\n"
-         << "Full execution time: " 
-         << duration_cast<milliseconds>(bk_time - start).count() 
-         << " ms\n"<<" saved to profiling.txt and clique_sizes.txt"<<endl;
-
-    saveResults(start, read_time, core_time, pos_time, bk_time);
-
-    return 0;
-}
\ No newline at end of file
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <iomanip>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <memory>
+
+#include "checkpoint.h"
+#include "clique.h"
+#include "external.h"
+#include "graph_io.h"
+#include "incremental.h"
+#include "max_clique.h"
+#include "relabel.h"
+#include "shard.h"
+
+using namespace std;
+using namespace chrono;
+
+// Writes one line per profiled root, roots[i] being the root at position
+// first + i of the degeneracy order; the file can be fed back through
+// --cost-hint.
+bool writeRootProfile(const char* path, const vector<RootCost>& roots, int first) {
+    ofstream out(path);
+    if (!out) return false;
+    out << "# position vertex ms nodes cliques P X\n";
+    for (size_t i = 0; i < roots.size(); ++i) {
+        const RootCost& r = roots[i];
+        out << first + i << " " << r.vertex << " " << r.ms << " " << r.nodes << " " << r.cliques
+            << " " << r.p << " " << r.x << "\n";
+    }
+    return true;
+}
+
+// Reads the per-vertex ms column of a root profile written by an earlier run.
+bool readCostHint(const char* path, int n, vector<double>& cost) {
+    ifstream in(path);
+    if (!in) return false;
+    cost.assign(n, 0.0);
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        long long position, vertex;
+        double ms;
+        if (sscanf(line.c_str(), "%lld %lld %lf", &position, &vertex, &ms) == 3 && vertex >= 0 && vertex < n) {
+            cost[vertex] = ms;
+        }
+    }
+    return true;
+}
+
+// Straggler summary of a root profile: the most expensive roots and a
+// histogram of root times by decade.
+void writeRootSummary(ostream& out, const vector<RootCost>& roots) {
+    const size_t top = 10;
+    double total_ms = 0;
+    for (const RootCost& r : roots) total_ms += r.ms;
+    vector<int> by_time(roots.size());
+    iota(by_time.begin(), by_time.end(), 0);
+    partial_sort(by_time.begin(), by_time.begin() + min(top, roots.size()), by_time.end(),
+                 [&](int a, int b) { return roots[a].ms > roots[b].ms; });
+
+    out << "\n==== ROOT PROFILE ====\n";
+    out << "Roots: " << roots.size() << ", total " << fixed << setprecision(3) << total_ms << " ms\n";
+    out << "Slowest roots (vertex: ms, share, nodes, cliques, |P|, |X|):\n";
+    for (size_t k = 0; k < min(top, roots.size()); ++k) {
+        const RootCost& r = roots[by_time[k]];
+        out << "  " << r.vertex << ": " << r.ms << " ms, " << setprecision(2)
+            << (total_ms > 0 ? 100 * r.ms / total_ms : 0.0) << "%, " << r.nodes << ", " << r.cliques
+            << ", " << r.p << ", " << r.x << "\n" << setprecision(3);
+    }
+
+    // Bucket b holds roots taking [10^(b-1), 10^b) microseconds.
+    vector<long long> count;
+    vector<double> time;
+    for (const RootCost& r : roots) {
+        const double us = r.ms * 1000;
+        size_t b = 0;
+        for (double limit = 1; us >= limit; limit *= 10) ++b;
+        if (count.size() <= b) {
+            count.resize(b + 1, 0);
+            time.resize(b + 1, 0);
+        }
+        count[b]++;
+        time[b] += r.ms;
+    }
+    out << "Root time histogram (roots, total ms):\n";
+    for (size_t b = 0; b < count.size(); ++b) {
+        if (count[b] == 0) continue;
+        out << "  " << (b == 0 ? string("< 1 us") : "< " + to_string((long long)pow(10, b)) + " us")
+            << ": " << count[b] << ", " << time[b] << "\n";
+    }
+    out.unsetf(ios::floatfield);
+}
+
+// Output file stem.txt, or stem.<i>-of-<k>.txt for shard i of k.
+string outputName(const char* stem, const string& shard_suffix) { return stem + shard_suffix + ".txt"; }
+
+// clique_sizes.txt: "size count" for every size >= 2 that occurs.
+void writeCliqueSizes(const vector<long long>& clique_sizes, const string& path = "clique_sizes.txt") {
+    ofstream clique_file(path);
+    for (size_t i = 2; i < clique_sizes.size(); ++i) {
+        if (clique_sizes[i] > 0) {
+            clique_file << i << " " << clique_sizes[i] << "\n";
+        }
+    }
+}
+
+// Reads a clique_sizes.txt written by an earlier run.
+bool readCliqueSizes(const string& path, vector<long long>& clique_sizes) {
+    ifstream in(path);
+    if (!in) return false;
+    clique_sizes.clear();
+    long long size, count;
+    while (in >> size >> count) {
+        if (size < 0) return false;
+        if ((long long)clique_sizes.size() <= size) clique_sizes.resize(size + 1, 0);
+        clique_sizes[size] = count;
+    }
+    return in.eof();
+}
+
+void saveResults(const vector<long long>& clique_sizes,
+                const time_point<high_resolution_clock>& start,
+                const time_point<high_resolution_clock>& read_time,
+                const time_point<high_resolution_clock>& core_time,
+                const time_point<high_resolution_clock>& pos_time,
+                const time_point<high_resolution_clock>& bk_time,
+                high_resolution_clock::duration snapshot_time,
+                [[maybe_unused]] const SearchStats& stats,
+                const vector<RootCost>& roots,
+                const string& shard_suffix) {
+    writeCliqueSizes(clique_sizes, outputName("clique_sizes", shard_suffix));
+
+    ofstream profile_file(outputName("profiling", shard_suffix));
+    profile_file << "==== PROFILING ====\n";
+    profile_file << "Read time: " 
+                << duration_cast<milliseconds>(read_time - start).count() 
+                << " ms\n";
+    profile_file << "Core decomposition: " 
+                << duration_cast<milliseconds>(core_time - read_time).count() 
+                << " ms\n";
+    if (snapshot_time.count() > 0) {
+        profile_file << "Snapshot save: "
+                    << duration_cast<milliseconds>(snapshot_time).count()
+                    << " ms\n";
+    }
+    profile_file << "Position computation: " 
+                << duration_cast<milliseconds>(pos_time - core_time - snapshot_time).count() 
+                << " ms\n";
+    profile_file << "Bron-Kerbosch time: " 
+                << duration_cast<milliseconds>(bk_time - pos_time).count() 
+                << " ms\n";
+    if (!roots.empty()) writeRootSummary(profile_file, roots);
+    profile_file.close();
+
+#ifdef CLIQUE_STATS
+    // Search-tree counters, only collected in -DCLIQUE_STATS builds.
+    ofstream stats_file("search_stats.json");
+    stats.write_json(stats_file);
+#endif
+}
+
+// max_clique.txt: the clique size, then its vertices on one line.
+void writeMaxClique(const vector<int>& clique, const string& path = "max_clique.txt") {
+    ofstream clique_file(path);
+    clique_file << clique.size() << "\n";
+    for (size_t i = 0; i < clique.size(); ++i) clique_file << (i ? " " : "") << clique[i];
+    clique_file << "\n";
+}
+
+bool readMaxClique(const string& path, vector<int>& clique) {
+    ifstream in(path);
+    long long size;
+    if (!(in >> size) || size < 0) return false;
+    clique.resize(size);
+    for (int& v : clique) {
+        if (!(in >> v)) return false;
+    }
+    return true;
+}
+
+// shard.<i>-of-<k>.txt: what the merge needs to know the shards fit
+// together, "checksum <hex> min-size <K> roots <first> <last> of <n>". The
+// checksum chains snapshot_checksum over the neighbours, then the order,
+// both in the input's vertex ids.
+struct ShardInfo {
+    uint64_t checksum = 0;
+    int min_size = 0;
+    int first = 0, last = 0, n = 0;
+};
+
+bool writeShardInfo(const ShardInfo& info, const string& path) {
+    ofstream out(path);
+    out << "checksum " << hex << info.checksum << dec << " min-size " << info.min_size << " roots " << info.first << " "
+        << info.last << " of " << info.n << "\n";
+    return bool(out);
+}
+
+bool readShardInfo(const string& path, ShardInfo& info) {
+    ifstream in(path);
+    string word;
+    return bool(in >> word >> hex >> info.checksum >> dec >> word >> info.min_size >> word >> info.first >> info.last >>
+                word >> info.n);
+}
+
+// Output of --max-clique: the clique itself in max_clique.txt and the phase
+// times in profiling.txt.
+void saveMaxClique(const vector<int>& clique,
+                   const time_point<high_resolution_clock>& start,
+                   const time_point<high_resolution_clock>& read_time,
+                   const time_point<high_resolution_clock>& search_time) {
+    writeMaxClique(clique);
+
+    ofstream profile_file("profiling.txt");
+    profile_file << "==== PROFILING ====\n";
+    profile_file << "Read time: "
+                << duration_cast<milliseconds>(read_time - start).count()
+                << " ms\n";
+    profile_file << "Maximum clique search: "
+                << duration_cast<milliseconds>(search_time - read_time).count()
+                << " ms\n";
+    profile_file.close();
+}
+
+// --update: applies a batch of edge changes to the histogram in
+// clique_sizes.txt, searching only around the changed edges. With a
+// snapshot path the updated graph is saved too, as the base for the next
+// batch.
+int updateCliqueSizes(const CSRGraph& adj, const char* batch_path, const char* save_binary,
+                      const CliqueOptions& options, const time_point<high_resolution_clock>& start,
+                      const time_point<high_resolution_clock>& read_time) {
+    vector<EdgeChange> batch;
+    if (!load_edge_changes(batch_path, batch)) {
+        cerr << "Cannot read edge changes " << batch_path << endl;
+        return 1;
+    }
+    vector<long long> clique_sizes;
+    if (!readCliqueSizes("clique_sizes.txt", clique_sizes)) {
+        cerr << "Cannot read clique_sizes.txt of the base graph" << endl;
+        return 1;
+    }
+    const vector<EdgeChange> changes = net_edge_changes(adj, batch);
+    const vector<long long> delta = clique_size_delta(adj, changes, options);
+    if (clique_sizes.size() < delta.size()) clique_sizes.resize(delta.size(), 0);
+    for (size_t s = 2; s < delta.size(); ++s) clique_sizes[s] += delta[s];
+    writeCliqueSizes(clique_sizes);
+    auto update_time = high_resolution_clock::now();
+
+    if (save_binary) {
+        CSRGraph updated;
+        apply_edge_changes(adj, changes, updated);
+        if (!save_snapshot(save_binary, updated, nullptr)) {
+            cerr << "Cannot write snapshot " << save_binary << endl;
+            return 1;
+        }
+    }
+    auto save_time = high_resolution_clock::now();
+
+    const long long inserted = count_if(changes.begin(), changes.end(), [](const EdgeChange& c) { return c.insert; });
+    long long total_cliques = 0;
+    int largest_clique_size = 0;
+    for (size_t s = 2; s < clique_sizes.size(); ++s) {
+        total_cliques += clique_sizes[s];
+        if (clique_sizes[s] > 0) largest_clique_size = s;
+    }
+    cout << "==== RESULTS ====\n"
+         << "Edges changed: " << changes.size() << " (+" << inserted << ", -" << changes.size() - inserted << ")\n"
+         << "Largest Clique Size: " << largest_clique_size << "\n"
+         << "Total Maximal Cliques: " << total_cliques << "\n"
+         << "Full execution time: "
+         << duration_cast<milliseconds>(save_time - start).count()
+         << " ms\n"<<" saved to profiling.txt and clique_sizes.txt"<<endl;
+
+    ofstream profile_file("profiling.txt");
+    profile_file << "==== PROFILING ====\n";
+    profile_file << "Read time: "
+                << duration_cast<milliseconds>(read_time - start).count()
+                << " ms\n";
+    profile_file << "Clique update: "
+                << duration_cast<milliseconds>(update_time - read_time).count()
+                << " ms\n";
+    if (save_binary) {
+        profile_file << "Snapshot save: "
+                    << duration_cast<milliseconds>(save_time - update_time).count()
+                    << " ms\n";
+    }
+    return 0;
+}
+
+vector<int> largestClique(const CliqueHistogram&) { return {}; }
+vector<int> largestClique(const CliqueSummary& summary) { return summary.largest(); }
+
+// --merge-shards: adds up the partial histograms of shards 0..k-1 (see
+// --shard) into clique_sizes.txt and keeps the largest of their cliques in
+// max_clique.txt. Fails if any shard's output is missing, or if the shards
+// did not split one graph and order into contiguous slices.
+int mergeShards(int shards) {
+    vector<long long> clique_sizes;
+    vector<int> largest;
+    ShardInfo previous;
+    for (int i = 0; i < shards; ++i) {
+        const string suffix = "." + to_string(i) + "-of-" + to_string(shards);
+        vector<long long> partial;
+        vector<int> clique;
+        ShardInfo info;
+        if (!readCliqueSizes(outputName("clique_sizes", suffix), partial) ||
+            !readMaxClique(outputName("max_clique", suffix), clique) ||
+            !readShardInfo(outputName("shard", suffix), info)) {
+            cerr << "Cannot read the output of shard " << i << "/" << shards << endl;
+            return 1;
+        }
+        const bool fits = i == 0 ? info.first == 0
+                                 : info.checksum == previous.checksum && info.min_size == previous.min_size &&
+                                       info.n == previous.n && info.first == previous.last;
+        if (!fits || (i + 1 == shards && info.last != info.n)) {
+            cerr << "Shard " << i << "/" << shards << " does not continue the order of the others" << endl;
+            return 1;
+        }
+        previous = info;
+        if (clique_sizes.size() < partial.size()) clique_sizes.resize(partial.size(), 0);
+        for (size_t s = 0; s < partial.size(); ++s) clique_sizes[s] += partial[s];
+        if (clique.size() > largest.size()) largest = move(clique);
+    }
+    writeCliqueSizes(clique_sizes);
+    writeMaxClique(largest);
+
+    const long long total_cliques = accumulate(clique_sizes.begin(), clique_sizes.end(), 0LL);
+    cout << "==== RESULTS ====\n"
+         << "Shards merged: " << shards << "\n"
+         << "Largest Clique Size: " << largest.size() << "\n"
+         << "Total Maximal Cliques: " << total_cliques << "\n"
+         << " saved to clique_sizes.txt and max_clique.txt" << endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    CliqueOptions options;
+    const char* input = nullptr;
+    const char* save_binary = nullptr;
+    const char* load_binary = nullptr;
+    const char* root_profile = nullptr;
+    const char* cost_hint = nullptr;
+    const char* relabel = nullptr;
+    const char* update = nullptr;
+    long long memory_budget_mb = 0;
+    int shard = 0, shards = 0;
+    int merge_shards = 0;
+    const char* checkpoint_path = nullptr;
+    double checkpoint_every = 60;
+    bool resume = false;
+    bool verify_binary = false;
+    bool max_clique = false;
+    bool usage_error = false;
+    for (int a = 1; a < argc; ++a) {
+        if (strcmp(argv[a], "--threads") == 0 && a + 1 < argc) {
+            options.threads = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "--bitset-threshold") == 0 && a + 1 < argc) {
+            options.bitset_threshold = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "--legacy-pivot") == 0) {
+            // Take the first vertex of P u X instead of the Tomita pivot.
+            options.pivot = PivotRule::First;
+        } else if (strcmp(argv[a], "--save-binary") == 0 && a + 1 < argc) {
+            save_binary = argv[++a];
+        } else if (strcmp(argv[a], "--load-binary") == 0 && a + 1 < argc) {
+            load_binary = argv[++a];
+        } else if (strcmp(argv[a], "--verify-binary") == 0) {
+            verify_binary = true;
+        } else if (strcmp(argv[a], "--root-profile") == 0 && a + 1 < argc) {
+            root_profile = argv[++a];
+        } else if (strcmp(argv[a], "--cost-hint") == 0 && a + 1 < argc) {
+            cost_hint = argv[++a];
+        } else if (strcmp(argv[a], "--relabel") == 0 && a + 1 < argc) {
+            relabel = argv[++a];
+            usage_error |= strcmp(relabel, "degeneracy") != 0 && strcmp(relabel, "rcm") != 0;
+        } else if (strcmp(argv[a], "--min-size") == 0 && a + 1 < argc) {
+            options.min_size = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "--update") == 0 && a + 1 < argc) {
+            update = argv[++a];
+        } else if (strcmp(argv[a], "--memory-budget") == 0 && a + 1 < argc) {
+            memory_budget_mb = atoll(argv[++a]);
+            usage_error |= memory_budget_mb <= 0;
+        } else if (strcmp(argv[a], "--shard") == 0 && a + 1 < argc) {
+            // Slice i of k, 0 <= i < k.
+            usage_error |= sscanf(argv[++a], "%d/%d", &shard, &shards) != 2 || shards < 1 || shard < 0 ||
+                           shard >= shards;
+        } else if (strcmp(argv[a], "--merge-shards") == 0 && a + 1 < argc) {
+            merge_shards = atoi(argv[++a]);
+            usage_error |= merge_shards < 1;
+        } else if (strcmp(argv[a], "--checkpoint") == 0 && a + 1 < argc) {
+            checkpoint_path = argv[++a];
+        } else if (strcmp(argv[a], "--checkpoint-every") == 0 && a + 1 < argc) {
+            checkpoint_every = atof(argv[++a]);
+            usage_error |= !(checkpoint_every >= 0);
+        } else if (strcmp(argv[a], "--resume") == 0) {
+            resume = true;
+        } else if (strcmp(argv[a], "--max-clique") == 0) {
+            max_clique = true;
+        } else if (!input) {
+            input = argv[a];
+        } else {
+            usage_error = true;
+        }
+    }
+    // The out-of-core mode streams an edge list into the --save-binary
+    // snapshot and enumerates from that; the root-level options need the
+    // in-memory enumerator.
+    if (memory_budget_mb > 0) {
+        usage_error |= (input && !save_binary) || relabel || root_profile || cost_hint;
+    }
+    // A shard covers a slice of the enumeration; the other modes do not split.
+    usage_error |= shards > 0 && (update || max_clique);
+    // Checkpoints cover the enumeration only; a root profile would only
+    // see the roots run since the last resume.
+    usage_error |= (resume && !checkpoint_path) || (checkpoint_path && (update || max_clique || root_profile));
+    if (merge_shards > 0 && !usage_error && !input && !load_binary) return mergeShards(merge_shards);
+    if (usage_error || !input == !load_binary || options.threads < 0) {
+        cerr << "Usage: " << argv[0] << " (<input_file> | --load-binary <snapshot>)"
+             << " [--verify-binary] [--save-binary <snapshot>] [--threads N] [--bitset-threshold K] [--legacy-pivot]"
+             << " [--root-profile <file>] [--cost-hint <root profile>] [--min-size K] [--relabel degeneracy|rcm] [--max-clique]"
+             << " [--update <edge changes>] [--memory-budget MB (with --save-binary for an edge list)] [--shard i/k]"
+             << " [--checkpoint <file> [--checkpoint-every S] [--resume]]\n"
+             << "       " << argv[0] << " --merge-shards k" << endl;
+        return 1;
+    }
+    if (options.threads == 0) options.threads = max(1u, thread::hardware_concurrency());
+    const int threads = options.threads;
+
+    auto start = high_resolution_clock::now();
+    CSRGraph adj;
+    int n = 0;
+    vector<int> order;
+    if (memory_budget_mb > 0 && input) {
+        if (!build_snapshot_external(input, save_binary, (size_t)memory_budget_mb << 20)) {
+            cerr << "Cannot build snapshot " << save_binary << " from " << input << endl;
+            return 1;
+        }
+        load_binary = save_binary;
+        save_binary = nullptr;
+    }
+    if (load_binary) {
+        if (!load_snapshot(load_binary, n, adj, order, verify_binary)) {
+            cerr << "Cannot load snapshot " << load_binary << endl;
+            return 1;
+        }
+    } else if (!load_edge_list(input, n, adj, threads)) {
+        cerr << "Cannot open " << input << endl;
+        return 1;
+    }
+    auto read_time = high_resolution_clock::now();
+    cout << "Dataset Read Sucessfully\n";
+
+    if (update) return updateCliqueSizes(adj, update, save_binary, options, start, read_time);
+
+    if (max_clique) {
+        // Branch and bound for the largest clique only; no enumeration.
+        vector<int> clique = maximum_clique(adj, threads);
+        auto search_time = high_resolution_clock::now();
+        cout << "==== RESULTS ====\n"
+             << "Maximum Clique Size: " << clique.size() << "\n"
+             << "Maximum Clique:";
+        for (int v : clique) cout << " " << v;
+        cout << "\nFull execution time: "
+             << duration_cast<milliseconds>(search_time - start).count()
+             << " ms\n"<<" saved to profiling.txt and max_clique.txt"<<endl;
+        saveMaxClique(clique, start, read_time, search_time);
+        return 0;
+    }
+
+    if (order.empty()) {
+        // The parallel peel gives the same order for any thread count, so
+        // shards and resumed runs need not agree on --threads.
+        order = parallel_core_decomposition(adj, threads);
+    }
+    auto core_time = high_resolution_clock::now();
+
+    high_resolution_clock::duration snapshot_time{0};
+    if (save_binary) {
+        if (!save_snapshot(save_binary, adj, &order)) {
+            cerr << "Cannot write snapshot " << save_binary << endl;
+            return 1;
+        }
+        snapshot_time = high_resolution_clock::now() - core_time;
+    }
+
+    // A shard's fingerprint, taken before --relabel renumbers the graph and
+    // turns a degeneracy order into the identity.
+    ShardInfo shard_info;
+    if (shards > 0) {
+        uint64_t& checksum = shard_info.checksum;
+        checksum = snapshot_checksum(reinterpret_cast<const char*>(adj.neighbour_data()), adj.entries() * sizeof(int));
+        checksum = snapshot_checksum(reinterpret_cast<const char*>(order.data()), order.size() * sizeof(int), checksum);
+    }
+
+    // Renumber the vertices for locality. By the degeneracy order itself,
+    // the order becomes the identity and every root's P is the tail of its
+    // neighbour list. original_id maps the new ids back for the output.
+    vector<int> original_id;
+    if (relabel) {
+        original_id = strcmp(relabel, "rcm") == 0 ? rcm_order(adj) : order;
+        CSRGraph relabeled;
+        relabel_graph(adj, original_id, relabeled, threads);
+        adj = move(relabeled);
+        vector<int> new_id(n);
+        for (int i = 0; i < n; ++i) new_id[original_id[i]] = i;
+        for (int& v : order) v = new_id[v];
+    }
+
+    CliqueEnumerator enumerator(adj, options);
+    enumerator.set_order(move(order));
+    enumerator.set_root_profiling(root_profile != nullptr);
+    vector<double> cost;
+    if (cost_hint) {
+        if (!readCostHint(cost_hint, n, cost)) {
+            cerr << "Cannot read cost hint " << cost_hint << endl;
+            return 1;
+        }
+        if (relabel) {
+            vector<double> by_new_id(n);
+            for (int i = 0; i < n; ++i) by_new_id[i] = cost[original_id[i]];
+            cost = move(by_new_id);
+        }
+        enumerator.set_cost_hint(cost);
+    }
+    auto pos_time = high_resolution_clock::now();
+
+    // With --shard, only the roots in this process's slice of the order;
+    // the slices are balanced by the hinted or estimated root cost.
+    int first = 0, last = n;
+    string shard_suffix;
+    if (shards > 0) {
+        tie(first, last) = shard_range(estimated_root_costs(adj, enumerator.order(), cost), shard, shards);
+        shard_suffix = "." + to_string(shard) + "-of-" + to_string(shards);
+        cout << "Shard " << shard << "/" << shards << ": roots " << first << " to " << last << " of " << n << "\n";
+    }
+
+    // With --resume, pick up where the checkpoint left off; without a
+    // checkpoint file yet, start from the beginning.
+    Checkpoint checkpoint;
+    if (checkpoint_path) {
+        checkpoint.fingerprint(adj, enumerator.order(), first, last, options.min_size);
+        if (resume && ifstream(checkpoint_path)) {
+            Checkpoint saved;
+            if (!load_checkpoint(checkpoint_path, saved) || !saved.same_run(checkpoint)) {
+                cerr << "Checkpoint " << checkpoint_path << " is unreadable or from a different run" << endl;
+                return 1;
+            }
+            checkpoint = move(saved);
+            cout << "Resuming at root " << checkpoint.done << " (roots " << first << " to " << last << ")\n";
+        }
+    }
+
+    unique_ptr<ShardedEnumerator> sharded;
+    if (memory_budget_mb > 0) {
+        sharded.reset(new ShardedEnumerator(adj, enumerator.order(), options, (size_t)memory_budget_mb << 20));
+    }
+    auto enumerate = [&](auto& visitor, int lo, int hi) {
+        if (sharded) sharded->run(visitor, lo, hi);
+        else enumerator.run(visitor, lo, hi);
+    };
+    vector<long long> clique_sizes;
+    vector<int> largest;
+    auto enumerateAll = [&](auto& visitor) {
+        enumerate(visitor, first, last);
+        clique_sizes = visitor.sizes();
+        largest = largestClique(visitor);
+    };
+    // With --checkpoint, one run over the roots not yet done, saving the
+    // finished prefix every checkpoint_every seconds as it grows.
+    auto enumerateCheckpointed = [&](auto& visitor) {
+        enumerate(visitor, checkpoint.done, last);
+        const bool saved = visitor.finish();
+        clique_sizes = checkpoint.sizes;
+        largest = checkpoint.largest;
+        return saved;
+    };
+    // A shard also reports its largest clique, which the histogram alone
+    // cannot give the merge.
+    bool enumerated = true;
+    if (checkpoint_path && shards > 0) {
+        CheckpointVisitor<true> visitor(checkpoint, checkpoint_path, checkpoint_every, threads);
+        enumerated = enumerateCheckpointed(visitor);
+    } else if (checkpoint_path) {
+        CheckpointVisitor<false> visitor(checkpoint, checkpoint_path, checkpoint_every, threads);
+        enumerated = enumerateCheckpointed(visitor);
+    } else if (shards > 0) {
+        CliqueSummary summary(threads);
+        enumerateAll(summary);
+    } else {
+        CliqueHistogram histogram(threads);
+        enumerateAll(histogram);
+    }
+    if (!enumerated) {
+        cerr << "Cannot write checkpoint " << checkpoint_path << endl;
+        return 1;
+    }
+    if (sharded) cout << "Shards: " << sharded->shards() << "\n";
+    auto bk_time = high_resolution_clock::now();
+
+    // Isolated vertices are maximal cliques of size 1; only sizes >= 2 are
+    // reported, and with --min-size only sizes >= K are enumerated at all.
+    if (clique_sizes.size() > 1) clique_sizes[1] = 0;
+    long long total_cliques = accumulate(clique_sizes.begin(), clique_sizes.end(), 0LL);
+    int largest_clique_size = clique_sizes.empty() ? 0 : clique_sizes.size() - 1;
+    while (largest_clique_size > 0 && clique_sizes[largest_clique_size] == 0) --largest_clique_size;
+    cout << "==== RESULTS ====\n"
+         << "Largest Clique Size: " << largest_clique_size << "\n"
+         << "Total Maximal Cliques" << (options.min_size > 2 ? " (size >= " + to_string(options.min_size) + ")" : "")
+         << ": " << total_cliques << "\n"
+         << "Full execution time: " 
+         << duration_cast<milliseconds>(bk_time - start).count() 
+         << " ms\n"<<" saved to "<<outputName("profiling", shard_suffix)<<" and "<<outputName("clique_sizes", shard_suffix)
+         <<(shards > 0 ? ", " + outputName("max_clique", shard_suffix) + " and " + outputName("shard", shard_suffix) : string())<<endl;
+
+    vector<RootCost> roots = enumerator.root_profile();
+    if (relabel) {
+        for (RootCost& r : roots) r.vertex = original_id[r.vertex];
+    }
+    if (root_profile && !writeRootProfile(root_profile, roots, enumerator.root_profile_first())) {
+        cerr << "Cannot write " << root_profile << endl;
+        return 1;
+    }
+    saveResults(clique_sizes, start, read_time, core_time, pos_time, bk_time, snapshot_time, enumerator.stats(),
+                roots, shard_suffix);
+    if (shards > 0) {
+        if (largest.size() < 2) largest.clear();
+        if (relabel) {
+            for (int& v : largest) v = original_id[v];
+            sort(largest.begin(), largest.end());
+        }
+        writeMaxClique(largest, outputName("max_clique", shard_suffix));
+        shard_info.min_size = options.min_size;
+        shard_info.first = first;
+        shard_info.last = last;
+        shard_info.n = n;
+        if (!writeShardInfo(shard_info, outputName("shard", shard_suffix))) {
+            cerr << "Cannot write " << outputName("shard", shard_suffix) << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "clique.h"
+#include "graph.h"
+
+// Vertex renumbering for locality. After relabel_graph(graph, order, out),
+// vertex order[i] of graph is vertex i of out. Relabeling by a degeneracy
+// order makes that order the identity: the later neighbours of i are then
+// the ids above i, i.e. the tail of its sorted neighbour list, and the
+// roots of a run walk the neighbour array front to back.
+
+// Builds the renumbered copy of graph. Each new neighbour list is the old
+// one mapped through the permutation and re-sorted; the lists are split
+// over `threads` workers.
+inline void relabel_graph(const CSRGraph& graph, const std::vector<int>& order, CSRGraph& out, int threads = 1) {
+    const int n = graph.size();
+    std::vector<int> new_id(n);
+    for (int i = 0; i < n; ++i) new_id[order[i]] = i;
+    std::vector<uint64_t> offsets(n + 1, 0);
+    for (int i = 0; i < n; ++i) offsets[i + 1] = offsets[i] + graph.degree(order[i]);
+    std::vector<int> neighbours(offsets[n]);
+    parallel_for(n, threads, [&](int, size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            int* first = neighbours.data() + offsets[i];
+            int* last = first;
+            for (int w : graph[order[i]]) *last++ = new_id[w];
+            std::sort(first, last);
+        }
+    });
+    out.assign(std::move(offsets), std::move(neighbours));
+}
+
+// Reverse Cuthill-McKee order: breadth-first from a minimum-degree vertex of
+// every component, neighbours taken by increasing degree, then reversed.
+// Keeps the ids of adjacent vertices close, which narrows every neighbour
+// list's spread over the vertex arrays.
+inline std::vector<int> rcm_order(const CSRGraph& graph) {
+    const int n = graph.size();
+    std::vector<int> by_degree(n);
+    for (int v = 0; v < n; ++v) by_degree[v] = v;
+    std::stable_sort(by_degree.begin(), by_degree.end(),
+                     [&](int a, int b) { return graph.degree(a) < graph.degree(b); });
+
+    std::vector<int> order;
+    order.reserve(n);
+    std::vector<char> seen(n, 0);
+    std::vector<int> next;
+    for (int s : by_degree) {
+        if (seen[s]) continue;
+        seen[s] = 1;
+        order.push_back(s);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            next.clear();
+            for (int w : graph[order[head]]) {
+                if (!seen[w]) {
+                    seen[w] = 1;
+                    next.push_back(w);
+                }
+            }
+            std::stable_sort(next.begin(), next.end(),
+                             [&](int a, int b) { return graph.degree(a) < graph.degree(b); });
+            order.insert(order.end(), next.begin(), next.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
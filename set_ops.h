@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SET_OPS_X86 1
+#include <immintrin.h>
+#endif
+
+// Sorted-set kernels shared by the clique engines. All inputs are sorted
+// ascending and free of duplicates; outputs are sorted and may alias a.
+//
+// Lists of similar length go through block-wise merges that compare W
+// elements of a against all rotations of W elements of b at once (SSE4.2,
+// AVX2 or AVX-512, picked at runtime from what the CPU supports and the
+// list lengths). When one
+// list is much shorter, its elements are located in the other by galloping
+// instead, so a small P against a hub's neighbourhood costs O(|P| log deg).
+
+namespace set_ops_detail {
+
+enum class Mode { Intersect, Difference, Count };
+
+// A short list is galloped into a long one once the long one is this many
+// times bigger.
+constexpr size_t kGallopRatio = 32;
+
+// First position in [lo, end) holding a value >= x, probing 1, 2, 4, ...
+// elements ahead before binary-searching the last step.
+inline const int* gallop(const int* lo, const int* end, int x) {
+    size_t step = 1;
+    const int* hi = lo;
+    while (hi < end && *hi < x) {
+        lo = hi + 1;
+        hi = (size_t)(end - hi) > step ? hi + step : end;
+        step <<= 1;
+    }
+    return std::lower_bound(lo, hi, x);
+}
+
+// Handles one element of a once it is known whether it occurs in b.
+template <Mode M>
+inline void emit(int x, bool in_b, int* out, size_t& n) {
+    if (M == Mode::Count) n += in_b;
+    else if ((M == Mode::Intersect) == in_b) out[n++] = x;
+}
+
+// Emits the W elements of an a-block, `matched` having bit k set when
+// block[k] occurs in b.
+template <Mode M>
+inline void emit_block(const int* block, int W, uint32_t matched, int* out, size_t& n) {
+    if (M == Mode::Count) {
+        n += __builtin_popcount(matched);
+        return;
+    }
+    uint32_t keep = M == Mode::Intersect ? matched : ~matched & ((W == 32 ? 0u : 1u << W) - 1);
+    while (keep) {
+        out[n++] = block[__builtin_ctz(keep)];
+        keep &= keep - 1;
+    }
+}
+
+// Scalar merge of a[0..na) against b[0..nb). The first elements of a may
+// already be known to occur in b: bit k of `matched` covers a[k].
+template <Mode M>
+inline size_t merge_scalar(const int* a, size_t na, const int* b, size_t nb, int* out, size_t n,
+                           uint32_t matched = 0) {
+    size_t i = 0, j = 0;
+    while (i < na) {
+        if (i < 32 && (matched >> i & 1)) {
+            emit<M>(a[i++], true, out, n);
+            continue;
+        }
+        while (j < nb && b[j] < a[i]) ++j;
+        const bool in_b = j < nb && b[j] == a[i];
+        emit<M>(a[i++], in_b, out, n);
+        if (in_b) ++j;
+        if (j == nb && M != Mode::Difference && (i >= 32 || !(matched >> i))) break;
+    }
+    return n;
+}
+
+// One element of the short list a at a time, galloping through the long b.
+template <Mode M>
+inline size_t gallop_short_a(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t n = 0;
+    const int* lo = b;
+    const int* end = b + nb;
+    for (size_t i = 0; i < na; ++i) {
+        lo = gallop(lo, end, a[i]);
+        const bool in_b = lo != end && *lo == a[i];
+        emit<M>(a[i], in_b, out, n);
+        if (in_b) ++lo;
+        else if (lo == end && M != Mode::Difference) break;
+    }
+    return n;
+}
+
+// a \ b for a much longer than b: every b element is galloped to in a and
+// the runs in between are copied.
+inline size_t difference_short_b(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t n = 0;
+    const int* lo = a;
+    const int* end = a + na;
+    for (size_t j = 0; j < nb && lo != end; ++j) {
+        const int* hit = gallop(lo, end, b[j]);
+        if (out + n != lo) std::copy(lo, hit, out + n);
+        n += hit - lo;
+        lo = hit;
+        if (lo != end && *lo == b[j]) ++lo;
+    }
+    if (out + n != lo) std::copy(lo, end, out + n);
+    return n + (end - lo);
+}
+
+#ifdef SET_OPS_X86
+
+template <Mode M>
+__attribute__((target("sse4.2")))
+size_t merge_sse(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t n = 0, i = 0, j = 0;
+    uint32_t matched = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i hit = _mm_cmpeq_epi32(va, vb);
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        matched |= _mm_movemask_ps(_mm_castsi128_ps(hit));
+        const int amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax) {
+            emit_block<M>(a + i, 4, matched, out, n);
+            matched = 0;
+            i += 4;
+        }
+        if (bmax <= amax) j += 4;
+    }
+    return merge_scalar<M>(a + i, na - i, b + j, nb - j, out, n, matched);
+}
+
+template <Mode M>
+__attribute__((target("avx2")))
+size_t merge_avx2(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    const __m256i rot = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    size_t n = 0, i = 0, j = 0;
+    uint32_t matched = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i hit = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r) {
+            vb = _mm256_permutevar8x32_epi32(vb, rot);
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(va, vb));
+        }
+        matched |= _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        const int amax = a[i + 7], bmax = b[j + 7];
+        if (amax <= bmax) {
+            emit_block<M>(a + i, 8, matched, out, n);
+            matched = 0;
+            i += 8;
+        }
+        if (bmax <= amax) j += 8;
+    }
+    return merge_scalar<M>(a + i, na - i, b + j, nb - j, out, n, matched);
+}
+
+template <Mode M>
+__attribute__((target("avx512f")))
+size_t merge_avx512(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t n = 0, i = 0, j = 0;
+    uint32_t matched = 0;
+    while (i + 16 <= na && j + 16 <= nb) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        __m512i vb = _mm512_loadu_si512((const void*)(b + j));
+        __mmask16 hit = _mm512_cmpeq_epi32_mask(va, vb);
+        for (int r = 1; r < 16; ++r) {
+            vb = _mm512_maskz_alignr_epi32(0xFFFF, vb, vb, 1);
+            hit |= _mm512_cmpeq_epi32_mask(va, vb);
+        }
+        matched |= hit;
+        const int amax = a[i + 15], bmax = b[j + 15];
+        if (amax <= bmax) {
+            if (M == Mode::Count) {
+                n += __builtin_popcount(matched);
+            } else {
+                const __mmask16 keep = M == Mode::Intersect ? matched : (__mmask16)~matched;
+                _mm512_mask_compressstoreu_epi32(out + n, keep, va);
+                n += __builtin_popcount(keep);
+            }
+            matched = 0;
+            i += 16;
+        }
+        if (bmax <= amax) j += 16;
+    }
+    return merge_scalar<M>(a + i, na - i, b + j, nb - j, out, n, matched);
+}
+
+#endif  // SET_OPS_X86
+
+using MergeFn = size_t (*)(const int*, size_t, const int*, size_t, int*);
+
+struct Tier {
+    MergeFn intersect, difference, count;
+};
+
+template <Mode M>
+size_t merge_plain(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    return merge_scalar<M>(a, na, b, nb, out, 0);
+}
+
+#define SET_OPS_TIER(fn) Tier{fn<Mode::Intersect>, fn<Mode::Difference>, fn<Mode::Count>}
+
+// Wider blocks only pay off on longer lists (a W-wide block step costs W
+// compares), so every list length gets the best kernel for its size class:
+// 4-wide below kMediumMin elements, 8-wide below kWideMin, 16-wide above.
+constexpr size_t kMediumMin = 192;
+constexpr size_t kWideMin = 512;
+
+struct Kernels {
+    Tier narrow, medium, wide;
+    const char* name;
+
+    const Tier& pick(size_t shorter) const {
+        return shorter < kMediumMin ? narrow : shorter < kWideMin ? medium : wide;
+    }
+};
+
+// Kernels for the instruction sets the CPU supports, resolved once.
+inline const Kernels& kernels() {
+    static const Kernels chosen = []() -> Kernels {
+        Kernels k{SET_OPS_TIER(merge_plain), SET_OPS_TIER(merge_plain), SET_OPS_TIER(merge_plain), "scalar"};
+#ifdef SET_OPS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2")) {
+            k.narrow = k.medium = k.wide = SET_OPS_TIER(merge_sse);
+            k.name = "sse4.2";
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            k.medium = k.wide = SET_OPS_TIER(merge_avx2);
+            k.name = "avx2";
+        }
+        if (__builtin_cpu_supports("avx512f")) {
+            k.wide = SET_OPS_TIER(merge_avx512);
+            k.name = "avx512";
+        }
+#endif
+        return k;
+    }();
+    return chosen;
+}
+
+#undef SET_OPS_TIER
+
+}  // namespace set_ops_detail
+
+// Widest instruction set the block merges use on this CPU.
+inline const char* set_ops_isa() { return set_ops_detail::kernels().name; }
+
+// Writes a ∩ b to out and returns its size.
+inline size_t intersect(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    using namespace set_ops_detail;
+    if (na == 0 || nb == 0) return 0;
+    if (nb > kGallopRatio * na) return gallop_short_a<Mode::Intersect>(a, na, b, nb, out);
+    if (na > kGallopRatio * nb) return gallop_short_a<Mode::Intersect>(b, nb, a, na, out);
+    return kernels().pick(std::min(na, nb)).intersect(a, na, b, nb, out);
+}
+
+// Writes a \ b to out and returns its size.
+inline size_t difference(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    using namespace set_ops_detail;
+    if (nb == 0) return std::copy(a, a + na, out) - out;
+    if (na == 0) return 0;
+    if (nb > kGallopRatio * na) return gallop_short_a<Mode::Difference>(a, na, b, nb, out);
+    if (na > kGallopRatio * nb) return difference_short_b(a, na, b, nb, out);
+    return kernels().pick(std::min(na, nb)).difference(a, na, b, nb, out);
+}
+
+// |a ∩ b| without materializing it.
+inline size_t intersect_count(const int* a, size_t na, const int* b, size_t nb) {
+    using namespace set_ops_detail;
+    if (na == 0 || nb == 0) return 0;
+    if (nb > kGallopRatio * na) return gallop_short_a<Mode::Count>(a, na, b, nb, nullptr);
+    if (na > kGallopRatio * nb) return gallop_short_a<Mode::Count>(b, nb, a, na, nullptr);
+    return kernels().pick(std::min(na, nb)).count(a, na, b, nb, nullptr);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "clique.h"
+#include "graph.h"
+
+// Splitting one enumeration over several processes. Every maximal clique
+// belongs to the root at the earliest position of its vertices in the
+// degeneracy order, so cutting the positions into k contiguous slices
+// splits the cliques exactly: shard i runs CliqueEnumerator::run over its
+// slice only, and the k partial histograms add up to the full one. Every
+// shard must see the same graph and order, so they must all read the same
+// input (edge list or snapshot).
+//
+// Root costs vary by orders of magnitude, so slices are cut by estimated
+// cost rather than by root count.
+
+// Estimated cost of the root at each position of order: 1 + its degree,
+// or cost_by_vertex (e.g. the ms column of a root profile) when given.
+// Squares of |P| overweight the deep roots; against measured root times
+// the plain degree splits within about 1.4x of even.
+inline std::vector<double> estimated_root_costs(const CSRGraph& adj, const std::vector<int>& order,
+                                                const std::vector<double>& cost_by_vertex = {}) {
+    const int n = order.size();
+    std::vector<double> cost(n);
+    for (int i = 0; i < n; ++i) {
+        const int v = order[i];
+        cost[i] = (int)cost_by_vertex.size() == n ? cost_by_vertex[v] : 1.0 + adj.degree(v);
+    }
+    return cost;
+}
+
+// Boundaries of `slices` slices of positions [0, cost.size()): slice j is
+// [bounds[j], bounds[j + 1]), cut where the running cost crosses a multiple
+// of total/slices. Slices may be empty, e.g. all of them for no positions.
+inline std::vector<int> slice_bounds(const std::vector<double>& cost, int slices) {
+    const int n = cost.size();
+    std::vector<double> prefix(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) prefix[i + 1] = prefix[i] + cost[i];
+    const double total = prefix.back();
+    std::vector<int> bounds(slices + 1, 0);
+    for (int j = 1; j < slices; ++j) {
+        const double target = total * j / slices;
+        const int at = std::partition_point(prefix.begin() + 1, prefix.end(), [&](double p) { return p < target; }) -
+                       prefix.begin();
+        bounds[j] = std::min(at, n);
+    }
+    bounds[slices] = n;
+    return bounds;
+}
+
+// Positions [first, last) of slice `shard` out of `shards`.
+inline std::pair<int, int> shard_range(const std::vector<double>& cost, int shard, int shards) {
+    const std::vector<int> bounds = slice_bounds(cost, shards);
+    return {bounds[shard], bounds[shard + 1]};
+}
+
+// Visitor for a shard: the clique-size histogram, as CliqueHistogram, plus
+// one largest clique.
+class CliqueSummary {
+    std::vector<std::vector<long long>> counts;
+    std::vector<std::vector<int>> best;
+
+public:
+    explicit CliqueSummary(int workers = 1) : counts(std::max(1, workers)), best(std::max(1, workers)) {}
+
+    void operator()(int worker, const int* clique, int size) {
+        std::vector<long long>& c = counts[worker];
+        if ((int)c.size() <= size) c.resize(size + 1, 0);
+        c[size]++;
+        if (size > (int)best[worker].size()) best[worker].assign(clique, clique + size);
+    }
+
+    std::vector<long long> sizes() const {
+        std::vector<long long> total;
+        for (const auto& c : counts) {
+            if (total.size() < c.size()) total.resize(c.size(), 0);
+            for (size_t s = 0; s < c.size(); ++s) total[s] += c[s];
+        }
+        return total;
+    }
+
+    // A largest clique seen (sorted), empty if none was.
+    std::vector<int> largest() const {
+        std::vector<int> clique;
+        for (const auto& b : best) {
+            if (b.size() > clique.size()) clique = b;
+        }
+        std::sort(clique.begin(), clique.end());
+        return clique;
+    }
+};